@@ -9,6 +9,6 @@ using Logging::logger;
 
 
 int cmd1() {
-    logger.debug("executing cmd1");    
+    logger().debug("executing cmd1");    
     return EXIT_SUCCESS;
 }
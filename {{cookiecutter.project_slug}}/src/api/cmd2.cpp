@@ -9,6 +9,6 @@ using Logging::logger;
 
 
 int cmd2() {
-    logger.debug("executing cmd2");
+    logger().debug("executing cmd2");
     return EXIT_SUCCESS;
 }
@@ -3,30 +3,811 @@
  *
  * @file
  */
-#include <getopt.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
 #include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iomanip>
 #include <iostream>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+#include "core/Arena.hpp"
+#include "core/CommandLine.hpp"
 #include "core/configure.hpp"
 #include "core/logging.hpp"
+#include "core/memory.hpp"
+#include "core/metrics.hpp"
+#include "core/numeric.hpp"
+#include "core/PerfCounters.hpp"
+#include "core/Profiler.hpp"
+#include "core/ThreadPool.hpp"
+#include "core/trace.hpp"
+#include "core/UnixSocket.hpp"
 #include "api/api.hpp"
+#include "defaults.hpp"
 #include "version.hpp"
 
 using configure::config;
+using configure::field;
 using Logging::logger;
 using Logging::level;
+using Logging::Level;
 using std::cout;
 using std::endl;
 using std::string;
+using std::string_view;
+using std::vector;
 
 
 namespace {  // internal linkage
 
+    /**
+     * Logging settings from the application config.
+     */
+    struct LoggingSettings {
+        Level level;
+    };
+
+    /**
+     * Metrics settings from the application config.
+     */
+    struct MetricsSettings {
+        string file;
+        unsigned interval;
+    };
+
+    /**
+     * Hardware counter settings from the application config.
+     */
+    struct PerfSettings {
+        bool counters;
+    };
+
+    /**
+     * Profiler settings from the application config.
+     */
+    struct ProfilerSettings {
+        string file;
+        unsigned frequency;
+    };
+
+    /**
+     * Server settings from the application config.
+     */
+    struct ServeSettings {
+        string socket;
+        unsigned timeout;
+    };
+
+    /**
+     * Thread pool settings from the application config.
+     */
+    struct ThreadSettings {
+        unsigned workers;
+        bool affinity;
+    };
+}
+
+
+/**
+ * Config fields for LoggingSettings.
+ */
+template <>
+struct configure::Schema<LoggingSettings> {
+    static constexpr auto fields{std::make_tuple(
+        field("logging.level", &LoggingSettings::level, [](const string& str) { return level(str); })
+    )};
+};
+
+
+/**
+ * Config fields for MetricsSettings.
+ */
+template <>
+struct configure::Schema<MetricsSettings> {
+    static constexpr auto fields{std::make_tuple(
+        field("metrics.file", &MetricsSettings::file),
+        field("metrics.interval", &MetricsSettings::interval)
+    )};
+};
+
+
+/**
+ * Config fields for PerfSettings.
+ */
+template <>
+struct configure::Schema<PerfSettings> {
+    static constexpr auto fields{std::make_tuple(
+        field("perf.counters", &PerfSettings::counters)
+    )};
+};
+
+
+/**
+ * Config fields for ProfilerSettings.
+ */
+template <>
+struct configure::Schema<ProfilerSettings> {
+    static constexpr auto fields{std::make_tuple(
+        field("profiler.file", &ProfilerSettings::file),
+        field("profiler.frequency", &ProfilerSettings::frequency)
+    )};
+};
+
+
+/**
+ * Config fields for ServeSettings.
+ */
+template <>
+struct configure::Schema<ServeSettings> {
+    static constexpr auto fields{std::make_tuple(
+        field("serve.socket", &ServeSettings::socket),
+        field("serve.timeout", &ServeSettings::timeout)
+    )};
+};
+
+
+/**
+ * Config fields for ThreadSettings.
+ */
+template <>
+struct configure::Schema<ThreadSettings> {
+    static constexpr auto fields{std::make_tuple(
+        field("threads.workers", &ThreadSettings::workers),
+        field("threads.affinity", &ThreadSettings::affinity)
+    )};
+};
+
+
+namespace {  // internal linkage
+
+    /**
+     * Subcommand handler.
+     *
+     * The handler is called with the parsed command line, and it returns the
+     * application exit code.
+     */
+    typedef int (*Handler)(const CommandLine&);
+
+    /**
+     * Define subcommand arguments.
+     */
+    typedef void (*Define)(CommandLine&);
+
+    /**
+     * Subcommand definition.
+     */
+    struct Command {
+        const char* name;
+        Handler exec;
+        Define define;  // nullptr if there are no arguments
+        bool nested;  // can be executed by batch or serve
+    };
+
+    int batch(const CommandLine& cmdl);
+    int serve(const CommandLine& cmdl);
+    int send(const CommandLine& cmdl);
+
+    /**
+     * All subcommands.
+     *
+     * Add new subcommands here; they are automatically added to the parser,
+     * the dispatch table, and the help message.
+     */
+    constexpr Command commands[]{
+        {"cmd1", [](const CommandLine&) { return cmd1(); }, nullptr, true},
+        {"cmd2", [](const CommandLine&) { return cmd2(); }, nullptr, true},
+        {"batch", batch, [](CommandLine& cmdl) {
+            cmdl.opt<unsigned>("jobs", 'j');
+            cmdl.pos("input");
+        }, false},
+        {"serve", serve, [](CommandLine& cmdl) {
+            cmdl.opt<string_view>("socket", 's');
+        }, false},
+        {"send", send, [](CommandLine& cmdl) {
+            cmdl.opt<string_view>("socket", 's');
+            cmdl.opt("stop");
+            cmdl.pos("args");
+        }, false},
+    };
+
+    /**
+     * Dispatch table entry for a subcommand.
+     *
+     * Metrics are looked up in the registry when a subcommand is first
+     * executed, so only executed subcommands are exported, and later
+     * executions do not build metric names or take the registry lock.
+     * Metrics for the optional reports are also looked up on first use so
+     * that they are only exported if the report is enabled.
+     */
+    struct Entry {
+        Handler exec;
+        const string prefix;  // metric name prefix, e.g. "command.cmd1"
+        mutable std::once_flag metrics_once;
+        mutable metrics::Counter* errors{nullptr};
+        mutable metrics::Histogram* duration{nullptr};
+        mutable std::once_flag perf_once;
+        mutable std::array<metrics::Counter*, PerfCounters::events> events{};
+        mutable std::once_flag memory_once;
+        mutable metrics::Counter* allocations{nullptr};
+        mutable metrics::Counter* allocated_bytes{nullptr};
+
+        /**
+         * Create an entry.
+         *
+         * @param command subcommand definition
+         */
+        explicit Entry(const Command& command) :
+            exec{command.exec},
+            prefix{string{"command."} + command.name} {}
+    };
+
+    /**
+     * Get the subcommand dispatch table.
+     *
+     * The table is built once from `commands`, and it is safe to use from
+     * multiple threads.
+     *
+     * @return entries indexed by subcommand name
+     */
+    const std::unordered_map<string_view, Entry>& handlers() {
+        static const auto table{[]() {
+            std::unordered_map<string_view, Entry> table;
+            for (const auto& command: commands) {
+                table.try_emplace(command.name, command);
+            }
+            return table;
+        }()};
+        return table;
+    }
+
+    /**
+     * Determine if a subcommand can be executed by batch or serve.
+     *
+     * @param name subcommand name
+     * @return true for a nested subcommand
+     */
+    bool nested(string_view name) {
+        const auto iter{std::find_if(std::begin(commands), std::end(commands), [name](const Command& command) {
+            return command.name == name;
+        })};
+        return iter != std::end(commands) and iter->nested;
+    }
+
+    std::atomic<bool> perf_enabled{false};
+
+    /**
+     * Get the hardware counters for the current thread.
+     *
+     * Counters are opened on first use. If they are not available, a warning
+     * is logged once per process, and commands run without counters.
+     *
+     * @return counters, or nullptr if they are not available
+     */
+    PerfCounters* perf_counters() {
+        thread_local PerfCounters counters;
+        static std::atomic<bool> warned{false};
+        if (not counters.available()) {
+            if (not warned.exchange(true)) {
+                logger().warn("hardware counters are not available: " + counters.error());
+            }
+            return nullptr;
+        }
+        return &counters;
+    }
+
+    /**
+     * Report hardware counts for a subcommand.
+     *
+     * Counts are logged at the INFO level and added to the metrics registry,
+     * e.g. `command.cmd1.cycles`.
+     *
+     * @param entry subcommand entry
+     * @param sample event counts
+     */
+    void perf_report(const Entry& entry, const PerfCounters::Sample& sample) {
+        static constexpr const char* names[PerfCounters::events]{
+            "cycles", "instructions", "cache_misses", "branch_misses"
+        };
+        std::call_once(entry.perf_once, [&entry]() {
+            for (size_t event{0}; event < PerfCounters::events; ++event) {
+                entry.events[event] = &metrics::registry().counter(entry.prefix + '.' + names[event]);
+            }
+        });
+        std::ostringstream message;
+        message << entry.prefix << ": ipc=" << std::fixed << std::setprecision(2) << sample.ipc();
+        for (size_t event{0}; event < PerfCounters::events; ++event) {
+            if (sample.valid[event]) {
+                entry.events[event]->add(sample.counts[event]);
+                message << ' ' << names[event] << '=' << sample.counts[event];
+            }
+        }
+        logger().info(message.str());
+        return;
+    }
+
+    /**
+     * Report heap usage for a subcommand.
+     *
+     * Usage is logged at the INFO level and added to the metrics registry,
+     * e.g. `command.cmd1.allocations`, and the process peak RSS is updated.
+     * Usage includes any nested subcommands.
+     *
+     * @param entry subcommand entry
+     * @param usage heap usage by the subcommand
+     */
+    void memory_report(const Entry& entry, const memory::Stats& usage) {
+        static auto& peak_rss{metrics::registry().gauge("process.peak_rss_kib")};
+        std::call_once(entry.memory_once, [&entry]() {
+            entry.allocations = &metrics::registry().counter(entry.prefix + ".allocations");
+            entry.allocated_bytes = &metrics::registry().counter(entry.prefix + ".allocated_bytes");
+        });
+        const auto peak{memory::peak_rss()};
+        entry.allocations->add(usage.allocations);
+        entry.allocated_bytes->add(usage.bytes);
+        peak_rss.set(static_cast<std::int64_t>(peak));
+        logger().info(entry.prefix + ": allocations=" + std::to_string(usage.allocations)
+                    + " bytes=" + std::to_string(usage.bytes)
+                    + " live=" + std::to_string(usage.live)
+                    + " peak_rss_kib=" + std::to_string(peak));
+        return;
+    }
+
+    /**
+     * Define the command line grammar.
+     *
+     * Parsers are not shared between threads. Batch and serve commands reuse
+     * one parser per thread because parse() discards any previous results.
+     *
+     * @return new parser
+     */
+    CommandLine parser() {
+        CommandLine cmdl{true, false};  // strict, handle --help here
+        cmdl.opt("help", 'h');
+        cmdl.opt("version", 'v');
+        cmdl.opt<string_view>("config", 'c');
+        cmdl.opt<string_view>("warn", 'w');
+        cmdl.opt("metrics");
+        cmdl.opt<string_view>("trace");
+        cmdl.opt("profile-startup");
+        cmdl.opt<string_view>("profile");
+        cmdl.opt("perf");
+        for (const auto& command: commands) {
+            auto& sub{cmdl.sub(command.name)};
+            if (command.define) {
+                command.define(sub);
+            }
+        }
+        return cmdl;
+    }
+
+    /**
+     * Execute the subcommand for a parsed command line.
+     *
+     * The duration and failure count of each subcommand are recorded in the
+     * metrics registry. If hardware counters are enabled, events are counted
+     * for nested subcommands; the other subcommands execute nested ones, so
+     * they are not counted themselves. Heap usage is recorded if allocation
+     * tracking is enabled.
+     *
+     * @param cmdl parsed command line
+     * @return subcommand exit code
+     */
+    int dispatch(const CommandLine& cmdl) {
+        const auto& table{handlers()};
+        const auto iter{table.find(cmdl.subcommand())};
+        if (iter == table.end()) {
+            return EXIT_FAILURE;
+        }
+        const auto& entry{iter->second};
+        std::call_once(entry.metrics_once, [&entry]() {
+            entry.errors = &metrics::registry().counter(entry.prefix + ".errors");
+            entry.duration = &metrics::registry().histogram(entry.prefix + ".duration_ns");
+        });
+        const metrics::Timer timer{*entry.duration};
+        TRACE_SCOPE("command.dispatch");
+        // Handlers can allocate short-lived objects from Arena::current().
+        // Each thread reuses its arena, which is rewound when the command is
+        // finished, so batch and serve commands do not fragment the heap.
+        thread_local Arena arena;
+        const Arena::Scope scope{arena};
+        const auto counters{perf_enabled and nested(cmdl.subcommand()) ? perf_counters() : nullptr};
+        if (counters) {
+            counters->start();
+        }
+        const memory::Usage usage;
+        const auto status{entry.exec(cmdl)};
+        if (counters) {
+            perf_report(entry, counters->stop());
+        }
+        if (memory::tracking()) {
+            memory_report(entry, usage.get());
+        }
+        if (status != EXIT_SUCCESS) {
+            entry.errors->add();
+        }
+        return status;
+    }
+
+    /**
+     * Split a command line into arguments.
+     *
+     * Arguments are separated by whitespace, and single or double quotes can
+     * be used for arguments that contain whitespace.
+     *
+     * @param line command line
+     * @return arguments
+     */
+    vector<string> split(const string& line) {
+        vector<string> args;
+        string arg;
+        bool in_arg{false};
+        char quote{'\0'};
+        for (const auto chr: line) {
+            if (quote != '\0') {
+                if (chr == quote) {
+                    quote = '\0';
+                }
+                else {
+                    arg += chr;
+                }
+            }
+            else if (chr == '"' or chr == '\'') {
+                quote = chr;
+                in_arg = true;
+            }
+            else if (std::isspace(static_cast<unsigned char>(chr))) {
+                if (in_arg) {
+                    args.push_back(std::move(arg));
+                    arg.clear();
+                    in_arg = false;
+                }
+            }
+            else {
+                arg += chr;
+                in_arg = true;
+            }
+        }
+        if (quote != '\0') {
+            throw std::runtime_error("unterminated quote");
+        }
+        if (in_arg) {
+            args.push_back(std::move(arg));
+        }
+        return args;
+    }
+
+    /**
+     * Execute subcommand arguments in this process.
+     *
+     * The arguments consist of a subcommand and its arguments, e.g. `cmd1`.
+     * Config and logging are not reinitialized, so global options are
+     * parsed but ignored. Only nested subcommands are allowed.
+     *
+     * @param args subcommand arguments
+     * @return subcommand exit code
+     */
+    int execute(vector<string> args) {
+        args.insert(args.begin(), "{{ cookiecutter.app_name }}");
+        vector<char*> argv;
+        for (auto& arg: args) {
+            argv.push_back(arg.data());
+        }
+        // Building the grammar costs more than parsing a short command line,
+        // so each thread builds it once. Nested subcommands never call
+        // execute(), so the parser is not reentered during dispatch().
+        thread_local auto cmdl{parser()};
+        cmdl.parse(static_cast<int>(argv.size()), argv.data(), false);  // args outlive dispatch()
+        if (not nested(cmdl.subcommand())) {
+            throw std::runtime_error("invalid command");
+        }
+        return dispatch(cmdl);
+    }
+
+    /**
+     * Execute a subcommand line in this process.
+     *
+     * Errors are logged and returned as a failure status.
+     *
+     * @param line command line
+     * @return subcommand exit code
+     */
+    int execute(const string& line) {
+        try {
+            return execute(split(line));
+        }
+        catch (const std::exception& ex) {
+            logger().error(line + ": " + ex.what());
+            return EXIT_FAILURE;
+        }
+    }
+
+    /**
+     * Execute the batch command.
+     *
+     * Command lines are read from the input file or STDIN, and each one is
+     * executed by this process. Blank lines and lines beginning with '#' are
+     * ignored. The result of each command is written to STDOUT as a line of
+     * tab-separated values: the input line number, the exit code, and the
+     * command line. Results are written in input order. With more than one
+     * job, commands are executed in parallel by the application thread pool,
+     * so they must be independent. Jobs are limited to the pool size from the
+     * [threads] config, and 0 jobs uses the whole pool.
+     *
+     * @param cmdl parsed command line
+     * @return EXIT_SUCCESS if all commands were successful
+     */
+    int batch(const CommandLine& cmdl) {
+        const auto path{cmdl.has_arg("input") ? cmdl.get<string>("input") : "-"};
+        std::ifstream file;
+        if (path != "-") {
+            file.open(path);
+            if (not file) {
+                logger().error("could not open " + path);
+                return EXIT_FAILURE;
+            }
+        }
+        std::istream& input{path != "-" ? file : std::cin};
+        // Only batch uses the thread pool, so other subcommands do not read
+        // the [threads] config.
+        const auto threads{config().get<ThreadSettings>()};
+        auto& pool{thread_pool()};
+        pool.start(threads.workers, threads.affinity);  // workers start on demand
+        unsigned jobs{cmdl.has_arg("jobs") ? cmdl.get<unsigned>("jobs") : 1};
+        if (jobs == 0 or jobs > pool.size()) {
+            jobs = pool.size();
+        }
+        struct Task {
+            size_t lineno;
+            string line;
+            int status;
+        };
+        vector<Task> tasks;
+        const auto report([](const Task& task) {
+            cout << task.lineno << '\t' << task.status << '\t' << task.line << '\n';
+        });
+        string line;
+        for (size_t lineno{1}; std::getline(input, line); ++lineno) {
+            const auto start{line.find_first_not_of(" \t\r")};
+            if (start == string::npos or line[start] == '#') {
+                continue;
+            }
+            Task task{lineno, line, EXIT_FAILURE};
+            if (jobs == 1) {
+                // Report each result as soon as it is available.
+                task.status = execute(task.line);
+                report(task);
+                if (task.status != EXIT_SUCCESS) {
+                    tasks.push_back(std::move(task));  // track failures
+                }
+            }
+            else {
+                tasks.push_back(std::move(task));
+            }
+        }
+        if (jobs > 1) {
+            // Each job takes the next line when it is ready, so one slow
+            // command does not hold up a fixed share of the other lines.
+            std::atomic<size_t> next{0};
+            const auto worker([&tasks, &next]() {
+                for (auto pos{next++}; pos < tasks.size(); pos = next++) {
+                    tasks[pos].status = execute(tasks[pos].line);
+                }
+            });
+            vector<std::future<void>> futures;
+            for (unsigned pos{0}; pos < jobs; ++pos) {
+                futures.push_back(pool.submit(worker));
+            }
+            for (auto& future: futures) {
+                pool.wait(future);
+            }
+            for (const auto& task: tasks) {
+                report(task);
+            }
+        }
+        cout.flush();
+        for (const auto& task: tasks) {
+            if (task.status != EXIT_SUCCESS) {
+                return EXIT_FAILURE;
+            }
+        }
+        return EXIT_SUCCESS;
+    }
+
+    /**
+     * Get the server socket path.
+     *
+     * @param cmdl parsed command line
+     * @return `--socket` value or the configured default
+     */
+    string socket_path(const CommandLine& cmdl) {
+        if (cmdl.has_arg("socket")) {
+            return string{cmdl.get<string_view>("socket")};
+        }
+        return config().get<ServeSettings>().socket;
+    }
+
+    /**
+     * Redirect std::cout and std::clog to a string for the lifetime of this
+     * object.
+     */
+    class Capture {
+    public:
+        Capture() :
+            outbuf{cout.rdbuf(output.rdbuf())},
+            logbuf{std::clog.rdbuf(output.rdbuf())} {}
+
+        Capture(const Capture&) = delete;
+        Capture& operator=(const Capture&) = delete;
+
+        ~Capture() {
+            cout.rdbuf(outbuf);
+            std::clog.rdbuf(logbuf);
+        }
+
+        /**
+         * Get the captured output.
+         *
+         * @return output
+         */
+        string str() const {
+            return output.str();
+        }
+
+    private:
+        std::ostringstream output;
+        std::streambuf* const outbuf;
+        std::streambuf* const logbuf;
+    };
+
+    /**
+     * Execute the serve command.
+     *
+     * This runs a server on a Unix socket so that clients can execute
+     * subcommands without the application startup cost. Each request is the
+     * argument list for a nested subcommand, and the response is its exit code
+     * and captured output (STDOUT and log messages). Requests are executed one
+     * at a time, so a client that is idle for longer than the configured
+     * timeout is disconnected to let other clients be served. Only nested
+     * subcommands can be executed. An empty request stops the server.
+     *
+     * @param cmdl parsed command line
+     * @return application exit code
+     */
+    int serve(const CommandLine& cmdl) {
+        const auto path{socket_path(cmdl)};
+        const std::chrono::seconds timeout{config().get<ServeSettings>().timeout};
+        try {
+            const auto server{UnixSocket::listen(path)};
+            logger().info("listening on " + path);
+            UnixSocket::Message message;
+            for (;;) {
+                const auto client{server.accept()};
+                try {
+                    client.timeout(timeout);
+                    while (client.recv(message)) {
+                        if (message.empty()) {
+                            client.send({});
+                            logger().info("stopping server");
+                            return EXIT_SUCCESS;
+                        }
+                        int status{EXIT_FAILURE};
+                        string output;
+                        {
+                            const Capture capture;
+                            try {
+                                status = execute(message);
+                            }
+                            catch (const std::exception& ex) {
+                                logger().error(message.front() + ": " + ex.what());
+                            }
+                            output = capture.str();
+                        }
+                        client.send({std::to_string(status), std::move(output)});
+                    }
+                }
+                catch (const std::system_error& ex) {
+                    // Drop this client.
+                    logger().warn(ex.what());
+                }
+            }
+        }
+        catch (const std::system_error& ex) {
+            logger().error(ex.what());
+            return EXIT_FAILURE;
+        }
+    }
+
+    /**
+     * Execute the send command.
+     *
+     * This is a client for the serve command. The remaining arguments are
+     * sent to the server, e.g. `send cmd1`, and the captured output is
+     * written to STDOUT.
+     *
+     * @param cmdl parsed command line
+     * @return exit code of the remote subcommand
+     */
+    int send(const CommandLine& cmdl) {
+        try {
+            const auto client{UnixSocket::connect(socket_path(cmdl))};
+            UnixSocket::Message message;
+            if (not cmdl.has_arg("stop")) {
+                message = cmdl["args"];
+                if (message.empty()) {
+                    logger().error("no command to send");
+                    return EXIT_FAILURE;
+                }
+            }
+            client.send(message);
+            if (not client.recv(message)) {
+                throw std::system_error{ECONNRESET, std::generic_category(), "no response"};
+            }
+            if (cmdl.has_arg("stop")) {
+                return EXIT_SUCCESS;
+            }
+            int status;
+            if (message.size() != 2 or not numeric::parse(message[0], status)) {
+                throw std::system_error{EPROTO, std::generic_category(), "invalid response"};
+            }
+            cout << message[1] << std::flush;
+            return status;
+        }
+        catch (const std::system_error& ex) {
+            logger().error(ex.what());
+            return EXIT_FAILURE;
+        }
+    }
+
+    /**
+     * Write the duration of each startup phase.
+     *
+     * Phases are the spans recorded by this thread, so they include
+     * subcommand execution. The total is the time since the program started.
+     *
+     * @param stream output stream
+     */
+    void startup_profile(std::ostream& stream) {
+        const auto millis([](std::int64_t nanos) { return static_cast<double>(nanos) / 1e6; });
+        const auto flags{stream.flags()};
+        stream << "startup profile (ms):\n" << std::fixed << std::setprecision(3);
+        for (const auto& event: trace::events()) {
+            stream << "  " << std::left << std::setw(20) << event.name
+                   << std::right << std::setw(10) << millis(event.end - event.start) << '\n';
+        }
+        stream << "  " << std::left << std::setw(20) << "total"
+               << std::right << std::setw(10) << millis(trace::now()) << std::endl;
+        stream.flags(flags);
+        return;
+    }
+
     /**
      * Display a help message.
      */
     void help() {
-        cout << "{{ cookiecutter.app_name }} [-h]" << endl;
+        cout << "{{ cookiecutter.app_name }} [-h] [-v] [-c FILE] [-w LEVEL] [--metrics] [--trace FILE] [--profile-startup] [--profile FILE] [--perf] COMMAND" << endl;
+        cout << "{{ cookiecutter.app_name }} batch [-j JOBS] [FILE]" << endl;
+        cout << "{{ cookiecutter.app_name }} serve [-s SOCKET]" << endl;
+        cout << "{{ cookiecutter.app_name }} send [-s SOCKET] [--stop] [COMMAND...]" << endl;
+        cout << "commands:";
+        for (const auto& command: commands) {
+            cout << " " << command.name;
+        }
+        cout << endl;
         return;
     }
 }
@@ -36,69 +817,128 @@ namespace {  // internal linkage
  * Entry point for the command line interface.
  *
  * The arguments are as passed to main(). The first value of `argv` will be
- * the command name used to execute the application.
+ * the command name used to execute the application. This does not use any
+ * global parser state, so it may be called multiple times.
  *
  * @param argc size of argv
  * @param argv array of arguments from the command line
  * @return application exit code
  */
 int cli(int argc, char* argv[]) {
-    // The leading '+' for short_opts enables POSIXLY_CORRECT behavior, which
-    // halts option processing as soon as a non-option is encountered. This is
-    // necessary for implementing subcommands.
-    const char* short_opts{"+:hvw:"};
-    const option long_opts[]{
-        {"help", no_argument, nullptr, 'h'},
-        {"version", no_argument, nullptr, 'v'},
-        {"warn", required_argument, nullptr, 'w'},
-        {nullptr, 0, nullptr, 0}  // sentinel
-    };
-    string warn;
-    optind = 0;  // reset getopt parser (POSIXLY_CORRECT mode); not thread-safe
-    while (true) {
-        // Process options.
-        const int opt{getopt_long(argc, argv, short_opts, long_opts, nullptr)};
-        if (opt == -1) {
-            break;
-        }
-        switch (opt) {        
-            case 'h': 
-                help();
-                return EXIT_SUCCESS;
-            case 'v':
-                cout << "{{ cookiecutter.app_name }} v" << version() << endl;
-                return EXIT_SUCCESS;
-            case 'w':
-                warn = optarg;
-                break;
-            case '?':  // unknown option
-            case ':':  // missing option value
-            default:
-                help();
+    const auto entry{trace::now()};
+    auto cmdl{parser()};
+    try {
+        cmdl.parse(argc, argv, false);  // argv outlives cmdl
+    }
+    catch (const std::runtime_error&) {
+        // Unknown option, missing option value, or unknown command.
+        help();
+        return EXIT_FAILURE;
+    }
+    if (cmdl.has_arg("help")) {
+        help();
+        return EXIT_SUCCESS;
+    }
+    if (cmdl.has_arg("version")) {
+        cout << "{{ cookiecutter.app_name }} v" << version() << endl;
+        return EXIT_SUCCESS;
+    }
+    const string trace_path{cmdl.has_arg("trace") ? cmdl.get<string_view>("trace") : ""};
+    const auto profile{cmdl.has_arg("profile-startup")};
+    if (not trace_path.empty() or profile) {
+        trace::start();
+        trace::record("process.init", 0, entry);  // static initialization
+        trace::record("cli.parse", entry, trace::now());
+    }
+    const string warn{cmdl.has_arg("warn") ? cmdl.get<string_view>("warn") : ""};
+    {
+        TRACE_SCOPE("logger.start");
+        logger().start(level(warn.empty() ? "WARN" : warn));
+        logger().info("starting execution");
+    }
+    {
+        TRACE_SCOPE("config.load");
+        config().load_text(default_config);  // no file I/O
+        if (cmdl.has_arg("config")) {
+            // Override default values.
+            const auto path{cmdl.get<string_view>("config")};
+            try {
+                config().load(std::filesystem::path{path});
+            }
+            catch (const std::exception& ex) {
+                logger().error("could not load " + string{path} + ": " + ex.what());
                 return EXIT_FAILURE;
+            }
+        }
+        if (not warn.empty()) {
+            config()["logging.level"] = warn;
         }
     }
-    logger.start(level(warn.empty() ? "WARN" : warn));
-    logger.info("starting execution");
-    config.load("etc/config.toml");
-    if (not warn.empty()) {
-        config["logging.level"] = warn;
+    {
+        TRACE_SCOPE("logger.restart");
+        const auto settings{config().get<LoggingSettings>()};
+        logger().stop();  // clear handlers
+        logger().start(settings.level);
+    }
+    const auto export_settings{config().get<MetricsSettings>()};
+    std::optional<metrics::Exporter> exporter;
+    if (not export_settings.file.empty()) {
+        const std::chrono::seconds interval{std::max(export_settings.interval, 1u)};
+        exporter.emplace(metrics::registry(), export_settings.file, interval);
+    }
+    perf_enabled = cmdl.has_arg("perf") or config().get<PerfSettings>().counters;
+    auto profiler_settings{config().get<ProfilerSettings>()};
+    if (cmdl.has_arg("profile")) {
+        profiler_settings.file = cmdl.get<string_view>("profile");
     }
-    logger.stop();  // clear handlers
-    logger.start(level(config["logging.level"]));
     int status{EXIT_FAILURE};
-    if (optind == argc) {
+    if (cmdl.subcommand().empty()) {
         help();
     }
-    else if (argv[optind] == string("cmd1")) {
-        status = cmd1();
+    else {
+        // Profiling is a diagnostic, so the command runs even if the
+        // profiler cannot be started.
+        std::optional<Profiler> profiler;
+        if (not profiler_settings.file.empty()) {
+            try {
+                profiler.emplace(profiler_settings.frequency);
+                profiler->start();
+            }
+            catch (const std::exception& ex) {
+                logger().warn(string{"profiling is disabled: "} + ex.what());
+                profiler.reset();
+            }
+        }
+        status = dispatch(cmdl);
+        if (profiler) {
+            profiler->stop();
+            try {
+                profiler->write(std::filesystem::path{profiler_settings.file});
+            }
+            catch (const std::system_error& ex) {
+                logger().error(ex.what());
+            }
+            if (profiler->dropped() > 0) {
+                logger().warn("profiler dropped " + std::to_string(profiler->dropped()) + " samples");
+            }
+        }
+    }
+    exporter.reset();  // final write
+    if (cmdl.has_arg("metrics")) {
+        metrics::registry().dump(std::clog);
     }
-    else if (argv[optind] == string("cmd2")) {
-        status = cmd2();
+    if (profile) {
+        startup_profile(std::clog);
     }
-    else {
-        help();
+    if (not trace_path.empty()) {
+        try {
+            trace::write(std::filesystem::path{trace_path});
+        }
+        catch (const std::system_error& ex) {
+            logger().error(ex.what());
+        }
     }
-    logger.info("application complete");
+    trace::stop();
+    logger().info("application complete");
     return status;
 }
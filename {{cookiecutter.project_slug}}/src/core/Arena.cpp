@@ -0,0 +1,130 @@
+/**
+ * Implementation of the Arena class.
+ */
+#include "Arena.hpp"
+#include <algorithm>
+#include <cstdint>
+
+namespace {  // internal linkage
+
+    thread_local Arena* active{nullptr};
+}
+
+
+/**
+ * Block header.
+ *
+ * The usable memory immediately follows the header.
+ */
+struct alignas(std::max_align_t) Arena::Block {
+    Block* next;
+    size_t size;  // usable size
+
+    char* data() noexcept {
+        return reinterpret_cast<char*>(this + 1);
+    }
+};
+
+
+Arena::Scope::Scope(Arena& arena) noexcept :
+    arena{arena},
+    previous{active},
+    mark{arena.mark()} {
+    active = &arena;
+}
+
+
+Arena::Scope::~Scope() {
+    arena.rewind(mark);
+    active = previous;
+}
+
+
+std::pmr::memory_resource* Arena::current() noexcept {
+    return active ? active : std::pmr::get_default_resource();
+}
+
+
+Arena::Arena(size_t block_size, std::pmr::memory_resource* upstream) :
+    block_size{block_size},
+    upstream{upstream} {}
+
+
+Arena::~Arena() {
+    while (head) {
+        const auto next{head->next};
+        upstream->deallocate(head, sizeof(Block) + head->size, alignof(Block));
+        head = next;
+    }
+}
+
+
+Arena::Mark Arena::mark() const noexcept {
+    return {block, ptr};
+}
+
+
+void Arena::rewind(const Mark& mark) noexcept {
+    block = static_cast<Block*>(mark.block);
+    ptr = mark.ptr;
+    end = block ? block->data() + block->size : nullptr;
+    return;
+}
+
+
+void Arena::reset() noexcept {
+    rewind({nullptr, nullptr});
+    return;
+}
+
+
+size_t Arena::capacity() const noexcept {
+    size_t total{0};
+    for (auto iter{head}; iter; iter = iter->next) {
+        total += iter->size;
+    }
+    return total;
+}
+
+
+void* Arena::do_allocate(size_t bytes, size_t alignment) {
+    for (;;) {
+        if (ptr) {
+            const auto addr{reinterpret_cast<std::uintptr_t>(ptr)};
+            const auto aligned{reinterpret_cast<char*>((addr + alignment - 1) & ~(alignment - 1))};
+            if (aligned <= end and static_cast<size_t>(end - aligned) >= bytes) {
+                ptr = aligned + bytes;
+                return aligned;
+            }
+        }
+        advance(bytes + alignment);
+    }
+}
+
+
+void Arena::do_deallocate(void*, size_t, size_t) {
+    // Memory is reclaimed by rewind() or reset().
+    return;
+}
+
+
+bool Arena::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+
+void Arena::advance(size_t size) {
+    auto& link{block ? block->next : head};
+    if (not link or link->size < size) {
+        // Insert a new block here. Any following blocks are still reused.
+        const auto usable{std::max(block_size, size)};
+        const auto next{static_cast<Block*>(upstream->allocate(sizeof(Block) + usable, alignof(Block)))};
+        next->next = link;
+        next->size = usable;
+        link = next;
+    }
+    block = link;
+    ptr = block->data();
+    end = ptr + block->size;
+    return;
+}
@@ -0,0 +1,140 @@
+/**
+ * Header for the Arena class.
+ *
+ * @file
+ */
+#ifndef {{ cookiecutter.app_name|upper }}_ARENA_HPP
+#define {{ cookiecutter.app_name|upper }}_ARENA_HPP
+
+#include <cstddef>
+#include <memory_resource>
+
+
+/**
+ * Arena memory resource.
+ *
+ * Memory is allocated sequentially from large blocks, and deallocation is a
+ * no-op. Unlike `std::pmr::monotonic_buffer_resource`, the arena can be reset
+ * or rewound to a mark in constant time, and its blocks are kept for reuse.
+ * This is intended for many small allocations with the same lifetime, e.g.
+ * everything allocated while executing a command. An arena is not
+ * thread-safe.
+ */
+class Arena: public std::pmr::memory_resource {
+public:
+    /**
+     * A position in the arena.
+     */
+    struct Mark {
+        void* block;
+        char* ptr;
+    };
+
+    /**
+     * Use an arena for the current thread.
+     *
+     * While a Scope exists, current() returns its arena. When the scope ends,
+     * the arena is rewound to its position at the start of the scope, so all
+     * memory allocated within the scope is reclaimed. Scopes may be nested.
+     */
+    class Scope {
+    public:
+        /**
+         * Start a scope.
+         *
+         * @param arena arena to use
+         */
+        explicit Scope(Arena& arena) noexcept;
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        /**
+         * End the scope.
+         */
+        ~Scope();
+
+    private:
+        Arena& arena;
+        Arena* const previous;
+        const Mark mark;
+    };
+
+    /**
+     * Get the arena for the current thread.
+     *
+     * @return innermost Scope arena, or the default resource if there is none
+     */
+    static std::pmr::memory_resource* current() noexcept;
+
+    /**
+     * Construct an arena.
+     *
+     * @param block_size minimum size of each block allocated from upstream
+     * @param upstream resource for allocating blocks
+     */
+    explicit Arena(size_t block_size=64 * 1024,
+                   std::pmr::memory_resource* upstream=std::pmr::get_default_resource());
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /**
+     * Release all blocks.
+     */
+    ~Arena() override;
+
+    /**
+     * Get the current position.
+     *
+     * @return position to use with rewind()
+     */
+    Mark mark() const noexcept;
+
+    /**
+     * Deallocate everything allocated since a mark.
+     *
+     * @param mark position from mark()
+     */
+    void rewind(const Mark& mark) noexcept;
+
+    /**
+     * Deallocate everything.
+     *
+     * Blocks are kept for reuse.
+     */
+    void reset() noexcept;
+
+    /**
+     * Get the total size of all blocks.
+     *
+     * @return capacity in bytes
+     */
+    size_t capacity() const noexcept;
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+
+    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+private:
+    struct Block;
+
+    const size_t block_size;
+    std::pmr::memory_resource* const upstream;
+    Block* head{nullptr};
+    Block* block{nullptr};  // current block; nullptr before the first one
+    char* ptr{nullptr};
+    char* end{nullptr};
+
+    /**
+     * Move to the next block with room for an allocation.
+     *
+     * @param size minimum free space
+     */
+    void advance(size_t size);
+};
+
+#endif  // {{ cookiecutter.app_name|upper }}_ARENA_HPP
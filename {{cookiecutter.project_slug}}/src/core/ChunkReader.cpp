@@ -0,0 +1,34 @@
+/**
+ * Implementation of the ChunkReader class.
+ */
+#include "ChunkReader.hpp"
+#include <algorithm>
+
+using std::string_view;
+
+
+ChunkReader::ChunkReader(const std::filesystem::path& path, size_t chunk_size, ThreadPool& pool) :
+    file{path},
+    pool{pool} {
+    // Each chunk is read sequentially, so aggressive readahead is useful.
+    file.advise(MappedFile::SEQUENTIAL);
+    const auto text{file.view()};
+    chunk_size = std::max(chunk_size, size_t{1});
+    size_t begin{0};
+    while (begin < text.size()) {
+        auto end{text.find('\n', std::min(begin + chunk_size, text.size()) - 1)};
+        end = end == string_view::npos ? text.size() : end + 1;
+        parts.push_back(text.substr(begin, end - begin));
+        begin = end;
+    }
+}
+
+
+void ChunkReader::prefetch_next(size_t index) const {
+    if (++index >= parts.size()) {
+        return;
+    }
+    const auto offset{static_cast<size_t>(parts[index].data() - file.view().data())};
+    file.advise(MappedFile::WILLNEED, offset, parts[index].size());
+    return;
+}
@@ -0,0 +1,143 @@
+/**
+ * Header for the ChunkReader class.
+ *
+ * @file
+ */
+#ifndef {{ cookiecutter.app_name|upper }}_CHUNKREADER_HPP
+#define {{ cookiecutter.app_name|upper }}_CHUNKREADER_HPP
+
+#include <cstddef>
+#include <filesystem>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "MappedFile.hpp"
+#include "ThreadPool.hpp"
+
+
+/**
+ * Parallel line-oriented file reader.
+ *
+ * The file is memory mapped and split into chunks that end at a newline, so
+ * no line spans two chunks. Chunks are processed in parallel by a thread
+ * pool, and their results are merged in file order. This is intended for
+ * commands that scan large input files line by line.
+ *
+ * Chunk views refer to the mapped file, so they must not outlive this object.
+ */
+class ChunkReader {
+public:
+    /**
+     * Map a file and split it into chunks.
+     *
+     * A `std::system_error` exception is thrown if the file cannot be
+     * mapped.
+     *
+     * @param path file path
+     * @param chunk_size target chunk size; chunks are extended to the next
+     *   newline
+     * @param pool thread pool for processing chunks
+     */
+    explicit ChunkReader(const std::filesystem::path& path, size_t chunk_size=4 * 1024 * 1024,
+                         ThreadPool& pool=thread_pool());
+
+    /**
+     * Get all chunks.
+     *
+     * @return chunks in file order
+     */
+    const std::vector<std::string_view>& chunks() const {
+        return parts;
+    }
+
+    /**
+     * Process each chunk.
+     *
+     * @param func function called as `func(chunk)` for each chunk; the
+     *   result type must be default constructible
+     * @return results in file order
+     */
+    template <typename Func>
+    std::vector<std::invoke_result_t<Func&, std::string_view>> map(Func func) const;
+
+    /**
+     * Process each chunk and combine the results.
+     *
+     * Results are combined in file order, so `reduce` need not be
+     * commutative.
+     *
+     * @param init initial value
+     * @param func function called as `func(chunk)` for each chunk
+     * @param reduce function called as `reduce(lhs, rhs)`
+     * @return combined results
+     */
+    template <typename T, typename Func, typename Reduce>
+    T reduce(T init, Func func, Reduce reduce) const;
+
+    /**
+     * Call a function for each line in a chunk.
+     *
+     * Lines do not include the trailing newline. A final line without a
+     * newline is included.
+     *
+     * @param chunk text to split
+     * @param func function called as `func(line)`
+     */
+    template <typename Func>
+    static void lines(std::string_view chunk, Func&& func);
+
+private:
+    MappedFile file;
+    ThreadPool& pool;
+    std::vector<std::string_view> parts;
+
+    /**
+     * Hint that the chunk after this one will be read next.
+     *
+     * Each task processes a contiguous range of chunks, so the next chunk can
+     * be read ahead while this one is processed. The chunk being read is
+     * already covered by sequential readahead.
+     *
+     * @param index index of the chunk being read
+     */
+    void prefetch_next(size_t index) const;
+};
+
+
+template <typename Func>
+std::vector<std::invoke_result_t<Func&, std::string_view>> ChunkReader::map(Func func) const {
+    std::vector<std::invoke_result_t<Func&, std::string_view>> results(parts.size());
+    pool.parallel_for(size_t{0}, parts.size(), [this, &func, &results](size_t index) {
+        prefetch_next(index);
+        results[index] = func(parts[index]);
+    });
+    return results;
+}
+
+
+template <typename T, typename Func, typename Reduce>
+T ChunkReader::reduce(T init, Func func, Reduce reduce) const {
+    const auto map([this, &func](size_t index) {
+        prefetch_next(index);
+        return func(parts[index]);
+    });
+    return pool.parallel_reduce(size_t{0}, parts.size(), std::move(init), map, reduce);
+}
+
+
+template <typename Func>
+void ChunkReader::lines(std::string_view chunk, Func&& func) {
+    while (not chunk.empty()) {
+        const auto end{chunk.find('\n')};
+        if (end == std::string_view::npos) {
+            func(chunk);
+            break;
+        }
+        func(chunk.substr(0, end));
+        chunk.remove_prefix(end + 1);
+    }
+    return;
+}
+
+#endif  // {{ cookiecutter.app_name|upper }}_CHUNKREADER_HPP
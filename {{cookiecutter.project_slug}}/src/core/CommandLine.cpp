@@ -3,25 +3,27 @@
  */
 #include "CommandLine.hpp"
 #include <cstdlib>
+#include <cstring>
 #include <algorithm>
-#include <functional>
 #include <iostream>
+#include <iterator>
 #include <sstream>
 #include <utility>
 
-using std::find_if;
-using std::function;
-using std::multimap;
+using std::invalid_argument;
 using std::make_tuple;
 using std::runtime_error;
 using std::string;
+using std::string_view;
 using std::tuple;
 using std::vector;
 
 
-CommandLine::CommandLine(bool strict, bool help) :
+CommandLine::CommandLine(bool strict, bool help, bool respfiles) :
     strict(strict),
-    help(help) {
+    help(help),
+    respfiles(respfiles) {
+    flag_index.fill(noindex);
     if (help) {
         opt("help", 'h');
     }
@@ -30,44 +32,96 @@ CommandLine::CommandLine(bool strict, bool help) :
 
 
 bool CommandLine::has_arg(const std::string& name) const {
-    return arg_vals.find(name) != arg_vals.end();
+    const auto range(find_vals(name));
+    return range.first != range.second;
 }
 
 
-void CommandLine::parse(int argc, char* argv[]) {
-    vector<string> vargv{argv, argv + argc};
-    auto iter(vargv.begin());
-    parse_argv(iter, vargv.end());
+void CommandLine::parse(int argc, char* argv[], bool copy) {
+    reset();
+    argv_views.clear();
+    argv_views.reserve(argc);
+    for (int pos{0}; pos < argc; ++pos) {
+        argv_views.emplace_back(argv[pos]);
+    }
+    if (copy) {
+        // Copy all arguments into a single buffer and parse views of that.
+        size_t size{0};
+        for (const auto& arg: argv_views) {
+            size += arg.size();
+        }
+        buffer.resize(size);
+        auto data(buffer.data());
+        for (auto& arg: argv_views) {
+            std::memcpy(data, arg.data(), arg.size());
+            arg = string_view(data, arg.size());
+            data += arg.size();
+        }
+    }
+    arg_vals.reserve(argc);
+    auto iter(argv_views.cbegin());
+    parse_argv(iter, argv_views.cend());
     return;
 }
 
 
 void CommandLine::opt(const std::string& name, char flag, bool has_val) {
-    opt_args.push_back(CommandLine::OptArg{name, flag, has_val});
+    add_opt(name, flag, has_val, nullptr);
+    return;
+}
+
+
+void CommandLine::add_opt(const std::string& name, char flag, bool has_val, Convert convert) {
+    const auto code(static_cast<unsigned char>(flag));
+    if (code >= flag_index.size()) {
+        throw invalid_argument("invalid flag for option " + name);
+    }
+    if (flag != noflag and flag_index[code] != noindex) {
+        throw invalid_argument("duplicate flag for option " + name);
+    }
+    if (name_index.find(name) != name_index.end()) {
+        throw invalid_argument("duplicate option " + name);
+    }
+    const auto key(intern(name));
+    name_index.emplace(key, opt_args.size());
+    if (flag != noflag) {
+        flag_index[code] = opt_args.size();
+    }
+    opt_args.push_back(CommandLine::OptArg{key, flag, has_val, convert});
     return;
 }
 
 
 void CommandLine::pos(const std::string& name, size_t count) {
-    pos_args.push_back(CommandLine::PosArg{name, count});
+    pos_args.push_back(CommandLine::PosArg{intern(name), count, nullptr});
     return;
 }
 
 
 CommandLine& CommandLine::sub(const string& name) {
-    CommandLine cmdl{strict, help};
+    CommandLine cmdl{strict, help, respfiles};
     sub_args.emplace(make_pair(name, std::move(cmdl)));  // invalidates cmdl
     return sub_args[name];
 }
 
 
+const string& CommandLine::subcommand() const {
+    return subcmd;
+}
+
+
 vector<string> CommandLine::operator[](const std::string& name) const {
-    const auto range(arg_vals.equal_range(name));
-    vector<string> values;
-    for (auto iter(range.first); iter != range.second; ++iter) {
-        values.push_back(iter->second);
+    const auto range(values<string_view>(name));
+    return vector<string>(range.begin(), range.end());
+}
+
+
+std::pmr::vector<std::pmr::string> CommandLine::strings(const std::string& name, std::pmr::memory_resource* resource) const {
+    std::pmr::vector<std::pmr::string> strings{resource};
+    for (const auto value: values<string_view>(name)) {
+        strings.emplace_back(value);  // uses the vector's allocator
     }
-    return values;
+    return strings;
 }
 
 
@@ -89,45 +143,47 @@ void CommandLine::parse_argv(ArgvIter& iter, const ArgvIter& end) {
     // If this is a subcommand, first argument will be the subcommand name.
     const_cast<string&>(name) = *iter++;
     parse_opts(iter, end);
-    if (help and has_arg("help")) {
-        std::cout << usage() << std::endl;
-        std::exit(EXIT_SUCCESS);
+    if (help) {
+        const auto is_help([](const ArgVal& arg) { return arg.key == "help"; });
+        if (std::any_of(arg_vals.begin(), arg_vals.end(), is_help)) {
+            std::cout << usage() << std::endl;
+            std::exit(EXIT_SUCCESS);
+        }
     }
     parse_subs(iter, end);  // subcommand will process remaining args
     parse_args(iter, end);
+    // Sort values by name for lookup. A stable sort preserves the command
+    // line order of values with the same name.
+    const auto less([](const ArgVal& lhs, const ArgVal& rhs) { return lhs.key < rhs.key; });
+    std::stable_sort(arg_vals.begin(), arg_vals.end(), less);
     return;
 }
 
 
 
 void CommandLine::parse_opts(ArgvIter& iter, const ArgvIter& end) {
+    vector<bool> seen(opt_args.size());
     while (iter != end && is_opt(iter)) {
         // Process each option. At the end of the loop, 'argv_iter' will point
         // to the first positional argument.
-        string arg;
-        string val;
+        string_view arg;
+        string_view val;
         bool is_long;
         std::tie(arg, val, is_long) = read_opt(iter);
-        function<bool(const OptArg&)> found;
-        if (is_long) {
-            found = [arg](const OptArg& opt) { return opt.name == arg; };
-        }
-        else {
-            found = [arg](const OptArg& opt) { return opt.flag == arg[0]; };
-        }
-        auto opts_iter(find_if(opt_args.begin(), opt_args.end(), found));
-        if (opts_iter == opt_args.end()) {
+        const auto index(find_opt(arg, is_long));
+        if (index == noindex) {
             if (strict) {
-                throw runtime_error("unknown option: " + arg);
+                throw runtime_error("unknown option: " + string(arg));
             }
             continue;  // ignore unknown option
         }
-        const auto name(opts_iter->name);
-        if (opts_iter->has_val) {
+        const auto& opt(opt_args[index]);
+        const auto& name(opt.name);
+        if (opt.has_val) {
             if (val.empty()) {
                 // Next argument should be the option value, e.g. `--opt val`.
                 if (iter == end) {
-                    throw runtime_error("missing value for option " + name);
+                    throw runtime_error("missing value for option " + string(name));
                 }
                 val = *iter++;
             }
@@ -135,15 +191,19 @@ void CommandLine::parse_opts(ArgvIter& iter, const ArgvIter& end) {
         else {
             // For boolean options, the value is set to the option name.
             if (!val.empty()) {
-                throw runtime_error("unexpected value for option " + name);
+                throw runtime_error("unexpected value for option " + string(name));
             }
-            val = opts_iter->name;
+            val = name;
         }
-        if (not opts_iter->has_val and has_arg(name)) {
+        if (not opt.has_val and seen[index]) {
             // There should only be one instance of a boolean option.
             continue;
         }
-        arg_vals.emplace(make_pair(name, val));
+        seen[index] = true;
+        arg_vals.push_back(ArgVal{name, val});
+        if (opt.convert) {
+            opt.convert(val, arg_vals.back());
+        }
     }
     return;
 }
@@ -158,17 +218,13 @@ void CommandLine::parse_subs(ArgvIter& iter, const ArgvIter& end) {
         // Not a subcommand name.
         return;
     }
-    const auto& name(subs_iter->first);
-    if (not has_arg(name)) {
-        // Treat like a boolean option.
-        arg_vals.insert(make_pair(name, name));
-    }
+    const string_view name(subs_iter->first);
+    subcmd = name;
+    arg_vals.push_back(ArgVal{name, name});  // treat like a boolean option
     auto& cmdl(subs_iter->second);
     cmdl.parse_argv(iter, end);
-    for (auto vals_iter: cmdl.arg_vals) {
-        // Merge subcommand options with its parent.
-        arg_vals.insert(vals_iter);
-    }
+    // Merge subcommand values with its parent.
+    arg_vals.insert(arg_vals.end(), cmdl.arg_vals.begin(), cmdl.arg_vals.end());
     return;
 }
 
@@ -181,13 +237,23 @@ void CommandLine::parse_args(ArgvIter& iter, const ArgvIter& end) {
             last = end;
         }
         else {
-            last += arg.count;
-            if (last >= end) {
-                throw std::runtime_error("missing argument(s): " + arg.name);
+            if (static_cast<size_t>(end - iter) < arg.count) {
+                throw std::runtime_error("missing argument(s): " + string(arg.name));
             }
+            last = iter + arg.count;
         }
         for (; iter != last; ++iter)  {
-            arg_vals.insert(multimap<string, string>::value_type(arg.name, *iter));
+            if (respfiles and arg.count == 0 and iter->size() > 1 and iter->front() == respdel) {
+                if (arg.convert) {
+                    throw runtime_error("response files are not supported for " + string(arg.name));
+                }
+                arg_vals.push_back(ArgVal{arg.name, read_respfile(*iter), Kind::file});
+                continue;
+            }
+            arg_vals.push_back(ArgVal{arg.name, *iter});
+            if (arg.convert) {
+                arg.convert(*iter, arg_vals.back());
+            }
         }
     }
     if (strict and iter != end) {
@@ -197,14 +263,59 @@ void CommandLine::parse_args(ArgvIter& iter, const ArgvIter& end) {
 }
 
 
+string_view CommandLine::read_respfile(string_view arg) {
+    const auto path(arg.substr(1));
+    if (path == "-") {
+        streams.emplace_back(std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>());
+        return streams.back();
+    }
+    mapped.emplace_back(string(path));
+    return mapped.back().view();
+}
+
+
+void CommandLine::reset() {
+    arg_vals.clear();
+    subcmd.clear();
+    mapped.clear();
+    streams.clear();
+    for (auto& sub: sub_args) {
+        sub.second.reset();
+    }
+    return;
+}
+
+
+string_view CommandLine::intern(const string& name) {
+    names.push_back(name);
+    return names.back();
+}
+
+
+std::pair<vector<CommandLine::ArgVal>::const_iterator, vector<CommandLine::ArgVal>::const_iterator> CommandLine::find_vals(string_view name) const {
+    const auto less([](const ArgVal& lhs, const ArgVal& rhs) { return lhs.key < rhs.key; });
+    return std::equal_range(arg_vals.begin(), arg_vals.end(), ArgVal{name, {}}, less);
+}
+
+
+size_t CommandLine::find_opt(string_view arg, bool is_long) const {
+    if (is_long) {
+        const auto iter(name_index.find(arg));
+        return iter != name_index.end() ? iter->second : noindex;
+    }
+    const auto code(static_cast<unsigned char>(arg[0]));
+    return code < flag_index.size() ? flag_index[code] : noindex;
+}
+
+
 bool CommandLine::is_opt(ArgvIter& iter) {
     // Return true if this is an optional argument.
-    auto arg(*iter);
-    if (arg[0] != CommandLine::optdel) {
+    const auto& arg(*iter);
+    if (arg.empty() or arg[0] != CommandLine::optdel) {
         // This is a regular positional argument or subcommand name.
         return false;
     }
-    else if (arg.find_first_not_of(CommandLine::optdel) == string::npos) {
+    else if (arg.find_first_not_of(CommandLine::optdel) == string_view::npos) {
         // This argument is all hyphens.
         if (arg.size() > 1) {
             // A double hyphen signals the end of option processing. Here,
@@ -218,14 +329,15 @@ bool CommandLine::is_opt(ArgvIter& iter) {
 }
 
 
-tuple<string, string, bool> CommandLine::read_opt(ArgvIter& iter) {
+tuple<string_view, string_view, bool> CommandLine::read_opt(ArgvIter& iter) {
+    // The option and value are views of the argument, so no copies are made.
     auto opt(*iter++);
     auto pos(opt.find_first_not_of(CommandLine::optdel));
     auto is_long(pos > 1);
     opt = opt.substr(pos);
-    string val;
+    string_view val;
     if (is_long) {
-        if ((pos = opt.find('=')) != string::npos) {
+        if ((pos = opt.find('=')) != string_view::npos) {
             // Long option contains a value, e.g. `--opt=abc`
             val = opt.substr(pos+1);
             opt = opt.substr(0, pos);
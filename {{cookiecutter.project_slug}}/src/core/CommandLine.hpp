@@ -6,12 +6,24 @@
 #ifndef {{ cookiecutter.app_name|upper }}_COMMANDLINE_HPP
 #define {{ cookiecutter.app_name|upper }}_COMMANDLINE_HPP
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <deque>
+#include <iterator>
+#include <limits>
 #include <map>
 #include <memory>
+#include <memory_resource>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <tuple>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
+#include "MappedFile.hpp"
+#include "numeric.hpp"
 
 
 /**
@@ -51,6 +63,25 @@
  * All of a subcommand's arguments are visible to its parent (but the converse
  * is not true).
  *
+ * Parsed values are views into the argument strings, and they are stored in
+ * a single sorted array; parsing does not allocate memory for each argument.
+ * By default the arguments are first copied into one buffer owned by this
+ * object, but they can also be used in place if they will outlive it, e.g.
+ * the `argv` array passed to main().
+ *
+ * Options and positional arguments may be given a type when they are added.
+ * Typed values are converted once during parsing, and an invalid value is
+ * a parsing error. The get() and values() methods provide typed access
+ * to parsed values without copying them.
+ *
+ * Response files can be enabled for very long argument lists, e.g. more than
+ * the system ARG_MAX limit. An argument of the form `@path` in a set of
+ * positional arguments that takes all remaining arguments is replaced by
+ * the lines in that file, one argument per line (blank lines are ignored).
+ * Use `@-` to read arguments from STDIN. A response file is memory mapped,
+ * and its lines are split lazily as values are accessed; they are never
+ * copied.
+ *
  * POSIX command-line syntax:
  *   <http://www.gnu.org/software/libc/manual/html_node/Argument-Syntax.html>
  */
@@ -61,6 +92,9 @@ public:
      */
     static const char noflag{'\0'};
 
+    template <typename T>
+    class Range;
+
     /**
      * Command name.
      *
@@ -74,12 +108,23 @@ public:
      * With strict argument checking, unexpected options or positional
      * arguments will cause an exception to be thrown during parsing. The
      * default help option will display a message and exit; this option
-     * will be applied to any subcommands as well.
+     * will be applied to any subcommands as well, as will response files.
      *
      * @param strict use strict argument checking
      * @param help add `--help` option
+     * @param respfiles expand `@file` positional arguments
      */
-    CommandLine(bool strict=false, bool help=true);
+    CommandLine(bool strict=false, bool help=true, bool respfiles=false);
+
+    /**
+     * Move constructor.
+     *
+     * @param other object to move from
+     */
+    CommandLine(CommandLine&& other) = default;
+
+    CommandLine(const CommandLine&) = delete;
+    CommandLine& operator=(const CommandLine&) = delete;
 
     /**
      * Determine if an argument was passed on the command line.
@@ -92,22 +137,48 @@ public:
     /**
      * Parse command-line arguments.
      *
-     * The arguments are as passed to main().
+     * The arguments are as passed to main(). Any results from a previous call
+     * are discarded, so the same object can be used to parse multiple
+     * command lines.
+     *
+     * If `copy` is false, parsed values refer directly to the strings in
+     * `argv`, which must outlive this object (or the next call to parse()).
+     * This is always true for the arguments passed to main().
      *
      * @param argc argument count
      * @param argv argument values
+     * @param copy copy arguments into a buffer owned by this object
      */
-    void parse(int argc, char* argv[]);
+    void parse(int argc, char* argv[], bool copy=true);
 
     /**
      * Add an option.
      *
+     * Options are indexed by name and flag so that parsing each argument is
+     * a constant-time operation. A `std::invalid_argument` exception is
+     * thrown if the name or flag is already in use or if the flag is not an
+     * ASCII character.
+     *
      * @param name long name for this option
      * @param flag flag character for this option (optional)
      * @param has_val true if this option takes an argument
      */
     void opt(const std::string& name, char flag=noflag, bool has_val=false);
 
+    /**
+     * Add an option with a typed value.
+     *
+     * Supported types are `bool` for an option without a value, arithmetic
+     * types, `std::string`, and `std::string_view`. Arithmetic values are
+     * converted during parsing.
+     *
+     * @tparam T value type
+     * @param name long name for this option
+     * @param flag flag character for this option (optional)
+     */
+    template <typename T>
+    void opt(const std::string& name, char flag=noflag);
+
     /**
      * Add a set of positional arguments.
      *
@@ -115,6 +186,19 @@ public:
      * @param count number of arguments (all remaining arguments by default)
      */
     void pos(const std::string& name, size_t count=0);
+
+    /**
+     * Add a set of typed positional arguments.
+     *
+     * Supported types are arithmetic types, `std::string`, and
+     * `std::string_view`. Arithmetic values are converted during parsing.
+     *
+     * @tparam T value type
+     * @param name name for this set of arguments
+     * @param count number of arguments (all remaining arguments by default)
+     */
+    template <typename T>
+    void pos(const std::string& name, size_t count=0);
     
     /**
      * Add a subcommand.
@@ -124,6 +208,16 @@ public:
      */
     CommandLine& sub(const std::string& name);
 
+    /**
+     * Get the subcommand that was parsed.
+     *
+     * Only the immediate subcommand of this object is considered, e.g. for
+     * `git remote add` this is `remote`.
+     *
+     * @return subcommand name; empty if there was no subcommand
+     */
+    const std::string& subcommand() const;
+
     /**
      * Retrieve parsed option or positional argument values.
      *
@@ -134,6 +228,49 @@ public:
      * @return list of values; empty if there are none
      */
     std::vector<std::string> operator[](const std::string& name) const;
+
+    /**
+     * Retrieve argument values allocated from a memory resource.
+     *
+     * This is the same as operator[], but the result can be allocated from
+     * a short-lived arena, e.g. `Arena::current()`.
+     *
+     * @param name named values to retrieve
+     * @param resource memory resource for the result
+     * @return list of values; empty if there are none
+     */
+    std::pmr::vector<std::pmr::string> strings(const std::string& name, std::pmr::memory_resource* resource) const;
+
+    /**
+     * Retrieve a typed value.
+     *
+     * If an option is given more than once, the last value is used. For a
+     * `bool` this is the same as has_arg(). A `std::out_of_range` exception
+     * is thrown if there is no value or if the value does not fit in `T`,
+     * and a `std::logic_error` exception is thrown if `T` is incompatible
+     * with the type the argument was defined with.
+     *
+     * @tparam T value type
+     * @param name argument name
+     * @return value
+     */
+    template <typename T>
+    T get(const std::string& name) const;
+
+    /**
+     * Retrieve all values for an argument.
+     *
+     * The returned range refers to values stored in this object, and it is
+     * invalidated by the next call to parse(). Values are converted to `T`
+     * as for get(). Arguments from response files are streamed from the
+     * mapped file as the range is iterated.
+     *
+     * @tparam T value type
+     * @param name argument name
+     * @return values in command line order
+     */
+    template <typename T>
+    Range<T> values(const std::string& name) const;
  
     /**
      * Generate a usage message for all defined arguments.
@@ -143,23 +280,131 @@ public:
     std::string usage() const;
 
 private:
-    typedef std::vector<std::string>::iterator ArgvIter;
+    typedef std::vector<std::string_view>::const_iterator ArgvIter;
+    enum class Kind: unsigned char { text, integer, natural, real, file };
+    struct ArgVal {
+        std::string_view key;  // option, argument, or subcommand name
+        std::string_view val;  // entire contents for a response file
+        Kind kind{Kind::text};
+        union {
+            long long integer;
+            unsigned long long natural;
+            double real;
+        } num{};
+    };
+    typedef void (*Convert)(std::string_view, ArgVal&);
     struct OptArg {
-        std::string name;
+        std::string_view name;
         char flag;
         bool has_val;
+        Convert convert;  // nullptr for text values
     };
     struct PosArg {
-        std::string name;
+        std::string_view name;
         size_t count;
+        Convert convert;  // nullptr for text values
     };
     static const char optdel{'-'};
+    static const char respdel{'@'};
+    static constexpr size_t noindex{static_cast<size_t>(-1)};
     const bool strict;
     const bool help;
+    const bool respfiles;
+    std::deque<std::string> names;  // stable storage for argument names
     std::vector<OptArg> opt_args;
+    std::array<size_t, 128> flag_index;  // opt_args index for each ASCII flag
+    std::unordered_map<std::string_view, size_t> name_index;  // opt_args index
     std::vector<PosArg> pos_args;  // order must be preserved
-    std::map<std::string, CommandLine> sub_args;
-    std::multimap<std::string, std::string> arg_vals;
+    std::map<std::string, CommandLine, std::less<>> sub_args;
+    std::vector<char> buffer;  // copied arguments
+    std::vector<std::string_view> argv_views;
+    std::vector<ArgVal> arg_vals;  // sorted by key after parsing
+    std::string subcmd;
+    std::deque<MappedFile> mapped;  // response files
+    std::deque<std::string> streams;  // response file data from STDIN
+
+    /**
+     * Read a response file.
+     *
+     * @param arg response file argument, e.g. `@path`
+     * @return entire contents of the response file
+     */
+    std::string_view read_respfile(std::string_view arg);
+
+    /**
+     * Add an option definition.
+     *
+     * @param name long name for this option
+     * @param flag flag character for this option
+     * @param has_val true if this option takes an argument
+     * @param convert value conversion; nullptr for text values
+     */
+    void add_opt(const std::string& name, char flag, bool has_val, Convert convert);
+
+    /**
+     * Convert a parsed value during parsing.
+     *
+     * A `std::runtime_error` exception is thrown for an invalid value.
+     *
+     * @tparam T value type
+     * @param str value to convert
+     * @param arg destination for the converted value
+     */
+    template <typename T>
+    static void convert(std::string_view str, ArgVal& arg);
+
+    /**
+     * Get the conversion function for a value type.
+     *
+     * @tparam T value type
+     * @return conversion function; nullptr for text values
+     */
+    template <typename T>
+    static constexpr Convert converter();
+
+    /**
+     * Get a parsed value as the requested type.
+     *
+     * @tparam T value type
+     * @param arg parsed value
+     * @return typed value
+     */
+    template <typename T>
+    static T value(const ArgVal& arg);
+
+    /**
+     * Check that an integer fits in the requested type.
+     *
+     * @tparam T value type
+     * @tparam V stored value type
+     * @param val stored value
+     * @return `val` converted to T
+     */
+    template <typename T, typename V>
+    static T narrow(V val);
+
+    /**
+     * Store an argument name.
+     *
+     * @param name argument name
+     * @return view of the stored name; valid for the lifetime of this object
+     */
+    std::string_view intern(const std::string& name);
+
+    /**
+     * Find all values for an argument.
+     *
+     * @param name argument name
+     * @return (first, last) range of arg_vals
+     */
+    std::pair<std::vector<ArgVal>::const_iterator, std::vector<ArgVal>::const_iterator> find_vals(std::string_view name) const;
+
+    /**
+     * Discard all parsed values.
+     *
+     * This is applied recursively to all subcommands.
+     */
+    void reset();
 
     /**
      * Parse all arguments.
@@ -195,6 +440,15 @@ private:
      */
     void parse_subs(ArgvIter& iter, const ArgvIter& end);
 
+    /**
+     * Find an option definition.
+     *
+     * @param arg option name or flag
+     * @param is_long true if `arg` is a long name
+     * @return opt_args index, or `noindex` if this is an unknown option
+     */
+    size_t find_opt(std::string_view arg, bool is_long) const;
+
     /**
      * Determine if the next argument is an option.
      *
@@ -216,7 +470,285 @@ private:
      * @param argv_iter argv iterator
      * @return (opt, val, is_long) tuple
      */
-    std::tuple<std::string, std::string, bool> read_opt(ArgvIter& iter);
+    std::tuple<std::string_view, std::string_view, bool> read_opt(ArgvIter& iter);
+};
+
+
+
+/**
+ * Typed view of the parsed values for an argument.
+ *
+ * @tparam T value type
+ */
+template <typename T>
+class CommandLine::Range {
+public:
+    /**
+     * Iterator that converts each value on access.
+     */
+    class iterator {
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const T* pointer;
+        typedef T reference;
+
+        T operator*() const {
+            if (pos->kind == Kind::file) {
+                return CommandLine::value<T>(ArgVal{pos->key, line});
+            }
+            return CommandLine::value<T>(*pos);
+        }
+
+        iterator& operator++() {
+            if (pos->kind != Kind::file or not next_line()) {
+                ++pos;
+                load();
+            }
+            return *this;
+        }
+
+        iterator operator++(int) {
+            auto prev(*this);
+            ++*this;
+            return prev;
+        }
+
+        bool operator==(const iterator& other) const {
+            return pos == other.pos and line.data() == other.line.data();
+        }
+
+        bool operator!=(const iterator& other) const {
+            return not (*this == other);
+        }
+
+    private:
+        friend class Range;
+        typedef std::vector<ArgVal>::const_iterator Iter;
+
+        iterator(Iter pos, Iter last) :
+            pos(pos),
+            last(last) {
+            load();
+        }
+
+        /**
+         * Advance to the first line of a response file if necessary.
+         *
+         * Empty response files are skipped.
+         */
+        void load() {
+            line = {};
+            while (pos != last and pos->kind == Kind::file) {
+                rest = pos->val;
+                if (next_line()) {
+                    return;
+                }
+                ++pos;
+            }
+            return;
+        }
+
+        /**
+         * Advance to the next non-blank line of a response file.
+         *
+         * @return false if there are no more lines
+         */
+        bool next_line() {
+            while (not rest.empty()) {
+                const auto end(rest.find('\n'));
+                line = rest.substr(0, end);
+                rest = end == std::string_view::npos ? std::string_view{} : rest.substr(end + 1);
+                if (not line.empty() and line.back() == '\r') {
+                    line.remove_suffix(1);
+                }
+                if (not line.empty()) {
+                    return true;
+                }
+            }
+            line = {};
+            return false;
+        }
+
+        Iter pos;
+        Iter last;
+        std::string_view rest;  // unread part of the current response file
+        std::string_view line;  // current line of the current response file
+    };
+
+    iterator begin() const {
+        return iterator(first, last);
+    }
+
+    iterator end() const {
+        return iterator(last, last);
+    }
+
+    /**
+     * Count the values in this range.
+     *
+     * This is a linear operation if there are any response files.
+     *
+     * @return number of values
+     */
+    size_t size() const {
+        const auto is_file([](const ArgVal& arg) { return arg.kind == Kind::file; });
+        if (std::none_of(first, last, is_file)) {
+            return static_cast<size_t>(last - first);
+        }
+        return static_cast<size_t>(std::distance(begin(), end()));
+    }
+
+    bool empty() const {
+        return begin() == end();
+    }
+
+private:
+    friend class CommandLine;
+    typedef std::vector<ArgVal>::const_iterator Iter;
+    Range(Iter first, Iter last) : first(first), last(last) {}
+    Iter first;
+    Iter last;
 };
 
+
+template <typename T>
+void CommandLine::opt(const std::string& name, char flag) {
+    add_opt(name, flag, not std::is_same_v<T, bool>, converter<T>());
+    return;
+}
+
+
+template <typename T>
+void CommandLine::pos(const std::string& name, size_t count) {
+    static_assert(not std::is_same_v<T, bool>, "positional arguments cannot be bool");
+    pos_args.push_back(PosArg{intern(name), count, converter<T>()});
+    return;
+}
+
+
+template <typename T>
+T CommandLine::get(const std::string& name) const {
+    if constexpr (std::is_same_v<T, bool>) {
+        return has_arg(name);
+    }
+    else {
+        const auto range(find_vals(name));
+        if (range.first == range.second) {
+            throw std::out_of_range("no value for " + name);
+        }
+        const auto& arg(*std::prev(range.second));
+        if (arg.kind == Kind::file) {
+            // Find the last line of a response file.
+            const Range<std::string_view> values(range.first, range.second);
+            std::string_view last;
+            for (const auto val: values) {
+                last = val;
+            }
+            if (last.data() == nullptr) {
+                throw std::out_of_range("no value for " + name);
+            }
+            return value<T>(ArgVal{arg.key, last});
+        }
+        return value<T>(arg);
+    }
+}
+
+
+template <typename T>
+CommandLine::Range<T> CommandLine::values(const std::string& name) const {
+    const auto range(find_vals(name));
+    return Range<T>(range.first, range.second);
+}
+
+
+template <typename T>
+constexpr CommandLine::Convert CommandLine::converter() {
+    if constexpr (std::is_same_v<T, std::string> or std::is_same_v<T, std::string_view> or std::is_same_v<T, bool>) {
+        return nullptr;
+    }
+    else {
+        static_assert(std::is_arithmetic_v<T>, "unsupported value type");
+        return &CommandLine::convert<T>;
+    }
+}
+
+
+template <typename T>
+void CommandLine::convert(std::string_view str, ArgVal& arg) {
+    T val{};
+    if (not numeric::parse(str, val)) {
+        throw std::runtime_error("invalid value for " + std::string(arg.key) + ": " + std::string(str));
+    }
+    if constexpr (std::is_floating_point_v<T>) {
+        arg.kind = Kind::real;
+        arg.num.real = val;
+    }
+    else if constexpr (std::is_signed_v<T>) {
+        arg.kind = Kind::integer;
+        arg.num.integer = val;
+    }
+    else {
+        arg.kind = Kind::natural;
+        arg.num.natural = val;
+    }
+    return;
+}
+
+
+template <typename T>
+T CommandLine::value(const ArgVal& arg) {
+    if constexpr (std::is_same_v<T, std::string_view>) {
+        return arg.val;
+    }
+    else if constexpr (std::is_same_v<T, std::string>) {
+        return std::string(arg.val);
+    }
+    else {
+        static_assert(std::is_arithmetic_v<T> and not std::is_same_v<T, bool>, "unsupported value type");
+        switch (arg.kind) {
+            case Kind::integer:
+                return narrow<T>(arg.num.integer);
+            case Kind::natural:
+                return narrow<T>(arg.num.natural);
+            case Kind::real:
+                if constexpr (std::is_floating_point_v<T>) {
+                    return static_cast<T>(arg.num.real);
+                }
+                break;
+            case Kind::text:
+            case Kind::file:
+                break;
+        }
+        throw std::logic_error("incompatible type for " + std::string(arg.key));
+    }
+}
+
+
+template <typename T, typename V>
+T CommandLine::narrow(V val) {
+    if constexpr (std::is_floating_point_v<T>) {
+        return static_cast<T>(val);
+    }
+    else {
+        // Compare signed and unsigned values without implicit conversions.
+        typedef std::numeric_limits<T> Limits;
+        bool fits;
+        if constexpr (std::is_signed_v<V>) {
+            fits = std::is_signed_v<T>
+                ? val >= static_cast<long long>(Limits::min()) and val <= static_cast<long long>(Limits::max())
+                : val >= 0 and static_cast<unsigned long long>(val) <= static_cast<unsigned long long>(Limits::max());
+        }
+        else {
+            fits = val <= static_cast<unsigned long long>(Limits::max());
+        }
+        if (not fits) {
+            throw std::out_of_range("value out of range");
+        }
+        return static_cast<T>(val);
+    }
+}
+
+
 #endif  // {{ cookiecutter.app_name|upper }}_COMMANDLINE_HPP
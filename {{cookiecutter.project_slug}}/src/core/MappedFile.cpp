@@ -0,0 +1,86 @@
+/**
+ * Implementation of the MappedFile class.
+ */
+#include "MappedFile.hpp"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <system_error>
+#include <utility>
+
+using std::generic_category;
+using std::system_error;
+
+
+MappedFile::MappedFile(const std::filesystem::path& path) {
+    const int fd{open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+    if (fd == -1) {
+        throw system_error{errno, generic_category(), "cannot open " + path.string()};
+    }
+    struct stat info;
+    if (fstat(fd, &info) == -1) {
+        const int err{errno};
+        close(fd);
+        throw system_error{err, generic_category(), "cannot read " + path.string()};
+    }
+    if (info.st_size > 0) {
+        // A zero-length mapping is an error, so an empty file is represented
+        // by an empty view.
+        void* const addr{mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0)};
+        if (addr == MAP_FAILED) {
+            const int err{errno};
+            close(fd);
+            throw system_error{err, generic_category(), "cannot map " + path.string()};
+        }
+        data = static_cast<const char*>(addr);
+        size = static_cast<std::size_t>(info.st_size);
+    }
+    close(fd);  // mapping remains valid
+    return;
+}
+
+
+MappedFile::MappedFile(MappedFile&& other) noexcept :
+    data{std::exchange(other.data, nullptr)},
+    size{std::exchange(other.size, 0)} {}
+
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        unmap();
+        data = std::exchange(other.data, nullptr);
+        size = std::exchange(other.size, 0);
+    }
+    return *this;
+}
+
+
+void MappedFile::advise(Advice advice, std::size_t offset, std::size_t length) const noexcept {
+    if (offset >= size) {
+        return;
+    }
+    length = std::min(length, size - offset);
+    static const auto page{static_cast<std::size_t>(sysconf(_SC_PAGESIZE))};
+    const auto start{offset / page * page};  // must be page aligned
+    static constexpr int flags[]{MADV_NORMAL, MADV_SEQUENTIAL, MADV_RANDOM, MADV_WILLNEED};
+    madvise(const_cast<char*>(data) + start, length + (offset - start), flags[advice]);
+    return;
+}
+
+
+MappedFile::~MappedFile() {
+    unmap();
+}
+
+
+void MappedFile::unmap() noexcept {
+    if (data) {
+        munmap(const_cast<char*>(data), size);
+        data = nullptr;
+        size = 0;
+    }
+    return;
+}
@@ -0,0 +1,94 @@
+/**
+ * Header for the MappedFile class.
+ *
+ * @file
+ */
+#ifndef {{ cookiecutter.app_name|upper }}_MAPPEDFILE_HPP
+#define {{ cookiecutter.app_name|upper }}_MAPPEDFILE_HPP
+
+#include <cstddef>
+#include <filesystem>
+#include <string_view>
+
+
+/**
+ * Read-only memory map of a file.
+ *
+ * The file contents are accessed directly from the page cache without being
+ * copied into a buffer. The mapping remains valid for the lifetime of the
+ * object, so any views into the file must not outlive it.
+ */
+class MappedFile {
+public:
+    static constexpr std::size_t npos{static_cast<std::size_t>(-1)};
+
+    /**
+     * Map a file into memory.
+     *
+     * A `std::system_error` exception is thrown if the file cannot be opened
+     * or mapped.
+     *
+     * @param path file path
+     */
+    explicit MappedFile(const std::filesystem::path& path);
+
+    /**
+     * Move constructor.
+     *
+     * @param other object to move from; it will no longer own a mapping
+     */
+    MappedFile(MappedFile&& other) noexcept;
+
+    /**
+     * Move assignment.
+     *
+     * @param other object to move from; it will no longer own a mapping
+     * @return this object
+     */
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * Unmap the file.
+     */
+    ~MappedFile();
+
+    /**
+     * Expected access pattern for advise().
+     */
+    enum Advice { NORMAL, SEQUENTIAL, RANDOM, WILLNEED };
+
+    /**
+     * Give the kernel a hint about how the file will be accessed.
+     *
+     * This affects readahead and page reclamation. The range is expanded to
+     * page boundaries, and errors are ignored because this is only a hint.
+     *
+     * @param advice access pattern
+     * @param offset start of the range
+     * @param length range size; defaults to the rest of the file
+     */
+    void advise(Advice advice, std::size_t offset=0, std::size_t length=npos) const noexcept;
+
+    /**
+     * Access the file contents.
+     *
+     * @return view of the entire file
+     */
+    std::string_view view() const {
+        return {data, size};
+    }
+
+private:
+    const char* data{nullptr};
+    std::size_t size{0};
+
+    /**
+     * Release the mapping.
+     */
+    void unmap() noexcept;
+};
+
+#endif  // {{ cookiecutter.app_name|upper }}_MAPPEDFILE_HPP
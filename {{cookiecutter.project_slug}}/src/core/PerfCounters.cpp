@@ -0,0 +1,148 @@
+/**
+ * Implementation of the PerfCounters class.
+ */
+#include "PerfCounters.hpp"
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using std::uint64_t;
+
+
+namespace {  // internal linkage
+
+#if defined(__linux__)
+    /**
+     * Hardware event for each PerfCounters::Event.
+     */
+    constexpr uint64_t configs[PerfCounters::events]{
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES,
+    };
+
+    /**
+     * Open a counter for the calling thread.
+     *
+     * @param config hardware event
+     * @return file descriptor, or -1 on error
+     */
+    int open(uint64_t config) {
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;  // allowed for perf_event_paranoid <= 2
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+    }
+#endif
+}
+
+
+double PerfCounters::Sample::ipc() const noexcept {
+    if (not valid[CYCLES] or not valid[INSTRUCTIONS] or counts[CYCLES] == 0) {
+        return 0;
+    }
+    return static_cast<double>(counts[INSTRUCTIONS]) / static_cast<double>(counts[CYCLES]);
+}
+
+
+PerfCounters::PerfCounters() {
+    fds.fill(-1);
+#if defined(__linux__)
+    for (size_t event{0}; event < events; ++event) {
+        fds[event] = open(configs[event]);
+        if (fds[event] < 0 and reason.empty()) {
+            const auto error{errno};
+            reason = std::string{"perf_event_open: "} + std::strerror(error);
+            if (error == EACCES or error == EPERM) {
+                reason += " (perf_event_paranoid=" + std::to_string(paranoid()) + ")";
+            }
+        }
+    }
+#else
+    reason = "hardware counters are not supported on this platform";
+#endif
+}
+
+
+PerfCounters::~PerfCounters() {
+#if defined(__linux__)
+    for (const auto fd: fds) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+#endif
+}
+
+
+bool PerfCounters::available() const noexcept {
+    for (const auto fd: fds) {
+        if (fd >= 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+const std::string& PerfCounters::error() const noexcept {
+    return reason;
+}
+
+
+void PerfCounters::start() noexcept {
+#if defined(__linux__)
+    for (const auto fd: fds) {
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+    return;
+}
+
+
+PerfCounters::Sample PerfCounters::stop() noexcept {
+    Sample sample;
+#if defined(__linux__)
+    for (const auto fd: fds) {
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+    for (size_t event{0}; event < events; ++event) {
+        uint64_t values[3];  // count, time enabled, time running
+        if (fds[event] < 0 or ::read(fds[event], values, sizeof(values)) != sizeof(values)) {
+            continue;
+        }
+        if (values[2] > 0 and values[2] < values[1]) {
+            // The counter was multiplexed, so extrapolate to the full time.
+            values[0] = static_cast<uint64_t>(static_cast<double>(values[0]) * values[1] / values[2]);
+        }
+        sample.counts[event] = values[0];
+        sample.valid[event] = values[2] > 0;
+    }
+#endif
+    return sample;
+}
+
+
+int PerfCounters::paranoid() {
+    std::ifstream stream{"/proc/sys/kernel/perf_event_paranoid"};
+    int value{-1};
+    stream >> value;
+    return stream ? value : -1;
+}
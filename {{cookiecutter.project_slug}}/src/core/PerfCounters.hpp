@@ -0,0 +1,114 @@
+/**
+ * Header for the PerfCounters class.
+ *
+ * @file
+ */
+#ifndef {{ cookiecutter.app_name|upper }}_PERFCOUNTERS_HPP
+#define {{ cookiecutter.app_name|upper }}_PERFCOUNTERS_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+
+/**
+ * Hardware performance counters for the calling thread.
+ *
+ * This uses the Linux perf_event_open() interface to count user-space events.
+ * Access may be restricted by the kernel.perf_event_paranoid setting, and
+ * virtual machines often have no hardware counters. Counters that cannot be
+ * opened are reported as unavailable rather than as an error, so callers can
+ * always use this class. Other platforms have no counters.
+ */
+class PerfCounters {
+public:
+    /**
+     * Counted events.
+     */
+    enum Event { CYCLES, INSTRUCTIONS, CACHE_MISSES, BRANCH_MISSES };
+
+    static constexpr std::size_t events{4};
+
+    /**
+     * Event counts for one measurement.
+     */
+    struct Sample {
+        std::array<std::uint64_t, events> counts{};
+        std::array<bool, events> valid{};
+
+        /**
+         * Get an event count.
+         *
+         * @param event event
+         * @return count, or 0 if the event is not available
+         */
+        std::uint64_t operator[](Event event) const noexcept {
+            return counts[event];
+        }
+
+        /**
+         * Get the instructions per cycle.
+         *
+         * @return IPC, or 0 if it is not available
+         */
+        double ipc() const noexcept;
+    };
+
+    /**
+     * Open counters for the calling thread.
+     *
+     * The counters only count events for the thread that constructs this
+     * object.
+     */
+    PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    /**
+     * Close the counters.
+     */
+    ~PerfCounters();
+
+    /**
+     * Determine if any counters are available.
+     *
+     * @return true if at least one event can be counted
+     */
+    bool available() const noexcept;
+
+    /**
+     * Get the reason that counters are not available.
+     *
+     * @return error message, or an empty string if all counters are available
+     */
+    const std::string& error() const noexcept;
+
+    /**
+     * Reset the counters and start counting.
+     */
+    void start() noexcept;
+
+    /**
+     * Stop counting.
+     *
+     * Counts are scaled if the kernel had to multiplex the counters.
+     *
+     * @return event counts since start()
+     */
+    Sample stop() noexcept;
+
+    /**
+     * Get the kernel.perf_event_paranoid setting.
+     *
+     * @return setting, or -1 if it cannot be read
+     */
+    static int paranoid();
+
+private:
+    std::array<int, events> fds;
+    std::string reason;
+};
+
+#endif  // {{ cookiecutter.app_name|upper }}_PERFCOUNTERS_HPP
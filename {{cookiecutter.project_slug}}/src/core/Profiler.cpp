@@ -0,0 +1,198 @@
+/**
+ * Implementation of the Profiler class.
+ */
+#include "Profiler.hpp"
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <sys/time.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+using std::string;
+using std::vector;
+
+
+namespace {  // internal linkage
+
+    std::atomic<Profiler*> running_profiler{nullptr};
+    struct sigaction previous;
+
+    /**
+     * Number of frames in the signal handler and the kernel signal trampoline
+     * that precede the interrupted frame.
+     */
+    constexpr int skip{2};
+
+    /**
+     * Get the name of the function containing a code address.
+     *
+     * @param addr code address
+     * @return demangled function name, or the module and offset
+     */
+    string symbol(void* addr) {
+        Dl_info info;
+        if (dladdr(addr, &info) == 0) {
+            std::ostringstream stream;
+            stream << addr;
+            return stream.str();
+        }
+        string name;
+        if (info.dli_sname) {
+            int status;
+            const std::unique_ptr<char, decltype(&std::free)> demangled{
+                abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status), std::free
+            };
+            name = status == 0 ? demangled.get() : info.dli_sname;
+        }
+        else {
+            const auto offset{static_cast<char*>(addr) - static_cast<char*>(info.dli_fbase)};
+            std::ostringstream stream;
+            stream << std::filesystem::path{info.dli_fname}.filename().string() << "+0x" << std::hex << offset;
+            name = stream.str();
+        }
+        for (auto& chr: name) {
+            if (chr == ';') {
+                chr = ':';  // reserved for the folded format
+            }
+        }
+        return name;
+    }
+}
+
+
+Profiler::Profiler(unsigned frequency, size_t capacity, size_t depth) :
+    frequency{std::max(frequency, 1u)},
+    capacity{capacity},
+    depth{depth + skip},
+    frames(capacity * this->depth),
+    lengths(capacity) {}
+
+
+Profiler::~Profiler() {
+    stop();
+}
+
+
+void Profiler::start() {
+    Profiler* expected{nullptr};
+    if (not running_profiler.compare_exchange_strong(expected, this)) {
+        throw std::logic_error("a profiler is already running");
+    }
+    next = 0;
+    {
+        // The first call to backtrace() may load libgcc, which is not safe in
+        // a signal handler.
+        void* frame;
+        backtrace(&frame, 1);
+    }
+    struct sigaction action{};
+    action.sa_sigaction = handler;
+    action.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGPROF, &action, &previous);
+    const long period{1000000 / static_cast<long>(frequency)};  // us
+    const timeval interval{period / 1000000, period % 1000000};
+    const itimerval timer{interval, interval};
+    if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+        const auto error{errno};
+        sigaction(SIGPROF, &previous, nullptr);
+        running_profiler = nullptr;
+        throw std::system_error{error, std::generic_category(), "could not start profiler timer"};
+    }
+    running = true;
+    return;
+}
+
+
+void Profiler::stop() noexcept {
+    if (not running) {
+        return;
+    }
+    const itimerval timer{};
+    setitimer(ITIMER_PROF, &timer, nullptr);
+    running_profiler = nullptr;  // ignore signals that are already pending
+    sigaction(SIGPROF, &previous, nullptr);
+    running = false;
+    return;
+}
+
+
+size_t Profiler::samples() const noexcept {
+    return std::min(next.load(), capacity);
+}
+
+
+size_t Profiler::dropped() const noexcept {
+    const auto count{next.load()};
+    return count > capacity ? count - capacity : 0;
+}
+
+
+void Profiler::write(std::ostream& stream) const {
+    // Count identical stacks, and then resolve each unique address once.
+    std::map<vector<void*>, size_t> stacks;
+    for (size_t index{0}; index < samples(); ++index) {
+        const auto first{frames.begin() + static_cast<std::ptrdiff_t>(index * depth)};
+        if (lengths[index] > skip) {
+            ++stacks[vector<void*>(first + skip, first + lengths[index])];
+        }
+    }
+    std::map<void*, string> names;
+    for (const auto& [stack, count]: stacks) {
+        const char* separator{""};
+        for (auto iter{stack.rbegin()}; iter != stack.rend(); ++iter) {
+            // Return addresses point to the instruction after the call, which
+            // may be in the next function, so look up the call instruction.
+            auto addr{*iter};
+            if (iter != std::prev(stack.rend())) {
+                addr = static_cast<char*>(addr) - 1;
+            }
+            auto& name{names[addr]};
+            if (name.empty()) {
+                name = symbol(addr);
+            }
+            stream << separator << name;
+            separator = ";";
+        }
+        stream << ' ' << count << '\n';
+    }
+    stream.flush();
+    return;
+}
+
+
+void Profiler::write(const std::filesystem::path& path) const {
+    std::ofstream stream{path};
+    if (not stream) {
+        throw std::system_error{errno, std::generic_category(), "cannot write " + path.string()};
+    }
+    write(stream);
+    return;
+}
+
+
+void Profiler::handler(int, siginfo_t*, void*) {
+    // This must be async-signal-safe: no locks, no allocation.
+    const auto saved{errno};
+    const auto profiler{running_profiler.load()};
+    if (profiler) {
+        const auto index{profiler->next.fetch_add(1, std::memory_order_relaxed)};
+        if (index < profiler->capacity) {
+            const auto buffer{profiler->frames.data() + index * profiler->depth};
+            profiler->lengths[index] = backtrace(buffer, static_cast<int>(profiler->depth));
+        }
+    }
+    errno = saved;
+    return;
+}
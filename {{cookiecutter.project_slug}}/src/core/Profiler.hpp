@@ -0,0 +1,106 @@
+/**
+ * Header for the Profiler class.
+ *
+ * @file
+ */
+#ifndef {{ cookiecutter.app_name|upper }}_PROFILER_HPP
+#define {{ cookiecutter.app_name|upper }}_PROFILER_HPP
+
+#include <atomic>
+#include <csignal>
+#include <cstddef>
+#include <filesystem>
+#include <ostream>
+#include <vector>
+
+
+/**
+ * Statistical CPU profiler.
+ *
+ * A SIGPROF signal is delivered to the process at a fixed rate of CPU time,
+ * and the signal handler saves the stack of the interrupted thread into a
+ * preallocated buffer. The handler does not allocate or lock, so the cost of
+ * profiling is proportional to the sampling frequency. Samples are written
+ * in the folded-stack format used by flamegraph.pl and speedscope.
+ *
+ * Function names are resolved with dladdr(), so the application must be
+ * linked with exported symbols (-rdynamic); otherwise frames are written as
+ * module offsets. Only one profiler can be running at a time.
+ */
+class Profiler {
+public:
+    /**
+     * Construct a profiler.
+     *
+     * @param frequency samples per second of CPU time
+     * @param capacity maximum number of samples
+     * @param depth maximum frames per sample
+     */
+    explicit Profiler(unsigned frequency=99, size_t capacity=65536, size_t depth=64);
+
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    /**
+     * Stop profiling.
+     */
+    ~Profiler();
+
+    /**
+     * Start sampling.
+     *
+     * Any previous samples are discarded. A `std::logic_error` is thrown if
+     * another profiler is running, and a `std::system_error` is thrown if
+     * the timer cannot be started.
+     */
+    void start();
+
+    /**
+     * Stop sampling.
+     *
+     * The previous SIGPROF handler is restored.
+     */
+    void stop() noexcept;
+
+    /**
+     * Get the number of saved samples.
+     *
+     * @return sample count
+     */
+    size_t samples() const noexcept;
+
+    /**
+     * Get the number of samples that were dropped because the buffer was
+     * full.
+     *
+     * @return sample count
+     */
+    size_t dropped() const noexcept;
+
+    /**
+     * Write samples as folded stacks.
+     *
+     * Each line is a unique stack, from the outermost frame to the innermost
+     * separated by ';', followed by its sample count. This must not be called
+     * while the profiler is running.
+     *
+     * @param stream output stream
+     */
+    void write(std::ostream& stream) const;
+
+    /** @overload */
+    void write(const std::filesystem::path& path) const;
+
+private:
+    const unsigned frequency;
+    const size_t capacity;
+    const size_t depth;
+    std::vector<void*> frames;  // capacity x depth
+    std::vector<int> lengths;  // frames per sample
+    std::atomic<size_t> next{0};
+    bool running{false};
+
+    static void handler(int signal, siginfo_t* info, void* context);
+};
+
+#endif  // {{ cookiecutter.app_name|upper }}_PROFILER_HPP
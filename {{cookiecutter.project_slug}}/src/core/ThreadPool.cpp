@@ -0,0 +1,213 @@
+/**
+ * Implementation of the ThreadPool class.
+ */
+#include "ThreadPool.hpp"
+#include <algorithm>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using std::lock_guard;
+using std::mutex;
+using std::unique_lock;
+
+
+namespace {  // internal linkage
+
+    /**
+     * Identify the pool and deque of the current worker thread.
+     */
+    struct Worker {
+        const ThreadPool* pool;
+        size_t index;
+    };
+
+    thread_local Worker current{nullptr, 0};
+
+    /**
+     * Pin worker threads to CPUs.
+     *
+     * Workers are assigned round-robin to the CPUs this process is allowed to
+     * use. This is only supported on Linux; elsewhere it has no effect.
+     *
+     * @param threads worker threads
+     */
+    void pin(std::vector<std::thread>& threads) {
+#if defined(__linux__)
+        cpu_set_t allowed;
+        if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+            return;
+        }
+        std::vector<int> cpus;
+        for (int cpu{0}; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &allowed)) {
+                cpus.push_back(cpu);
+            }
+        }
+        for (size_t index{0}; index < threads.size() and not cpus.empty(); ++index) {
+            cpu_set_t cpuset;
+            CPU_ZERO(&cpuset);
+            CPU_SET(cpus[index % cpus.size()], &cpuset);
+            pthread_setaffinity_np(threads[index].native_handle(), sizeof(cpuset), &cpuset);
+        }
+#else
+        static_cast<void>(threads);
+#endif
+        return;
+    }
+}
+
+
+ThreadPool::ThreadPool(unsigned workers, bool affinity) :
+    workers{workers},
+    affinity{affinity} {}
+
+
+ThreadPool::~ThreadPool() {
+    stop();
+}
+
+
+void ThreadPool::start(unsigned workers, bool affinity) {
+    const lock_guard<mutex> lock{control};
+    if (not running) {
+        this->workers = workers;
+        this->affinity = affinity;
+    }
+    return;
+}
+
+
+void ThreadPool::stop() {
+    const lock_guard<mutex> lock{control};
+    if (not running) {
+        return;
+    }
+    {
+        const lock_guard<mutex> lock{sleep_mutex};
+        stopping = true;
+    }
+    wakeup.notify_all();
+    for (auto& thread: threads) {
+        thread.join();
+    }
+    threads.clear();
+    queues.clear();
+    stopping = false;
+    running = false;
+    return;
+}
+
+
+unsigned ThreadPool::size() const {
+    return workers > 0 ? workers : std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+
+void ThreadPool::spawn() {
+    const lock_guard<mutex> lock{control};
+    if (running) {
+        return;
+    }
+    const auto count{size()};
+    for (unsigned index{0}; index < count; ++index) {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    for (unsigned index{0}; index < count; ++index) {
+        threads.emplace_back(&ThreadPool::run, this, index);
+    }
+    if (affinity) {
+        pin(threads);
+    }
+    running = true;
+    return;
+}
+
+
+void ThreadPool::push(Task task) {
+    if (not running) {
+        spawn();
+    }
+    const auto index{current.pool == this ? current.index : next++ % queues.size()};
+    {
+        const lock_guard<mutex> lock{queues[index]->mutex};
+        queues[index]->tasks.push_back(std::move(task));
+        ++pending;
+    }
+    {
+        // Synchronize with a worker that is about to wait.
+        const lock_guard<mutex> lock{sleep_mutex};
+    }
+    wakeup.notify_one();
+    return;
+}
+
+
+bool ThreadPool::pop(Task& task) {
+    if (pending == 0 or not running) {
+        return false;
+    }
+    const auto count{queues.size()};
+    if (current.pool == this) {
+        // Take the newest task from this worker's own deque.
+        auto& queue{*queues[current.index]};
+        const lock_guard<mutex> lock{queue.mutex};
+        if (not queue.tasks.empty()) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            --pending;
+            return true;
+        }
+    }
+    // Steal the oldest task from another deque.
+    const auto start{current.pool == this ? current.index + 1 : next.load()};
+    for (size_t offset{0}; offset < count; ++offset) {
+        auto& queue{*queues[(start + offset) % count]};
+        const lock_guard<mutex> lock{queue.mutex};
+        if (not queue.tasks.empty()) {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            --pending;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+bool ThreadPool::run_pending() {
+    Task task;
+    if (not pop(task)) {
+        return false;
+    }
+    task();
+    return true;
+}
+
+
+void ThreadPool::run(size_t index) {
+    current = {this, index};
+    Task task;
+    for (;;) {
+        if (pop(task)) {
+            task();
+            task = nullptr;  // release captured state
+            continue;
+        }
+        unique_lock<mutex> lock{sleep_mutex};
+        wakeup.wait(lock, [this]() { return stopping or pending > 0; });
+        if (stopping and pending == 0) {
+            break;
+        }
+    }
+    current = {nullptr, 0};
+    return;
+}
+
+
+size_t ThreadPool::chunk_size(size_t count, size_t grain) const {
+    // Use several chunks per worker to balance uneven workloads.
+    const size_t chunks{size() * 4};
+    return std::max({(count + chunks - 1) / chunks, grain, size_t{1}});
+}
@@ -0,0 +1,312 @@
+/**
+ * Header for the ThreadPool class.
+ *
+ * @file
+ */
+#ifndef {{ cookiecutter.app_name|upper }}_THREADPOOL_HPP
+#define {{ cookiecutter.app_name|upper }}_THREADPOOL_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+/**
+ * Work-stealing thread pool.
+ *
+ * Each worker has its own task deque. Tasks submitted by a worker are added
+ * to its own deque, and tasks submitted by other threads are distributed
+ * round-robin. A worker executes its newest task first, and when its deque is
+ * empty it steals the oldest task from another worker.
+ *
+ * Worker threads are not created until the first task is submitted, so an
+ * unused pool has no cost. A thread waiting for a result via wait(),
+ * parallel_for(), or parallel_reduce() executes pending tasks until the result
+ * is ready, so these can be safely nested inside tasks.
+ */
+class ThreadPool {
+public:
+    /**
+     * Construct a pool with one worker per CPU.
+     */
+    ThreadPool() = default;
+
+    /**
+     * Construct a pool.
+     *
+     * @param workers number of worker threads; 0 for one per CPU
+     * @param affinity pin each worker to a CPU
+     */
+    explicit ThreadPool(unsigned workers, bool affinity=false);
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * Stop the pool.
+     */
+    ~ThreadPool();
+
+    /**
+     * Set the pool parameters.
+     *
+     * This has no effect if the pool is running.
+     *
+     * @param workers number of worker threads; 0 for one per CPU
+     * @param affinity pin each worker to a CPU
+     */
+    void start(unsigned workers, bool affinity=false);
+
+    /**
+     * Stop the pool.
+     *
+     * Workers finish all pending tasks before they exit. The pool will be
+     * restarted if more tasks are submitted. This must not be called while
+     * other threads are submitting tasks.
+     */
+    void stop();
+
+    /**
+     * Get the number of worker threads.
+     *
+     * @return pool size
+     */
+    unsigned size() const;
+
+    /**
+     * Submit a task for execution.
+     *
+     * Any exception thrown by the task is rethrown by the future.
+     *
+     * @param func callable object with no arguments
+     * @return future for the task result
+     */
+    template <typename Func>
+    std::future<std::invoke_result_t<std::decay_t<Func>&>> submit(Func&& func);
+
+    /**
+     * Wait for a task result.
+     *
+     * The calling thread executes pending tasks while it waits.
+     *
+     * @param future task future
+     * @return task result
+     */
+    template <typename T>
+    T wait(std::future<T>& future);
+
+    /**
+     * Call a function for each index in a range.
+     *
+     * The range is split into chunks that are executed in parallel, and this
+     * returns when all calls are complete. If any call throws an exception,
+     * the first one is rethrown here.
+     *
+     * @param first first index
+     * @param last one past the last index
+     * @param func function called as `func(index)`
+     * @param grain minimum number of indexes per chunk
+     */
+    template <typename Index, typename Func>
+    void parallel_for(Index first, Index last, Func func, Index grain=1);
+
+    /**
+     * Map a function over a range and reduce the results.
+     *
+     * The result is `reduce(...reduce(init, map(first))..., map(last - 1))`
+     * evaluated in chunks, so `reduce` must be associative. Chunk results are
+     * combined in index order, so the result is deterministic.
+     *
+     * @param first first index
+     * @param last one past the last index
+     * @param init initial value
+     * @param map function called as `map(index)`
+     * @param reduce function called as `reduce(lhs, rhs)`
+     * @param grain minimum number of indexes per chunk
+     * @return reduced value
+     */
+    template <typename Index, typename T, typename Map, typename Reduce>
+    T parallel_reduce(Index first, Index last, T init, Map map, Reduce reduce, Index grain=1);
+
+private:
+    typedef std::function<void()> Task;
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> threads;
+    unsigned workers{0};
+    bool affinity{false};
+    std::atomic<bool> running{false};
+    std::atomic<size_t> pending{0};
+    std::atomic<size_t> next{0};
+    std::mutex control;  // serializes spawn() and stop()
+    std::mutex sleep_mutex;  // guards stopping for wakeup
+    std::condition_variable wakeup;
+    bool stopping{false};
+
+    /**
+     * Create worker threads.
+     */
+    void spawn();
+
+    /**
+     * Add a task to a worker deque.
+     *
+     * @param task task to add
+     */
+    void push(Task task);
+
+    /**
+     * Remove a task from a worker deque.
+     *
+     * A worker checks its own deque first.
+     *
+     * @param task removed task
+     * @return false if there are no pending tasks
+     */
+    bool pop(Task& task);
+
+    /**
+     * Execute one pending task in the calling thread.
+     *
+     * @return false if there are no pending tasks
+     */
+    bool run_pending();
+
+    /**
+     * Worker thread loop.
+     *
+     * @param index worker index
+     */
+    void run(size_t index);
+
+    /**
+     * Wait until a future is ready.
+     *
+     * The calling thread executes pending tasks while it waits.
+     *
+     * @param future task future
+     */
+    template <typename T>
+    void join(const std::future<T>& future);
+
+    /**
+     * Split a range into chunks.
+     *
+     * @param count range size
+     * @param grain minimum chunk size
+     * @return chunk size
+     */
+    size_t chunk_size(size_t count, size_t grain) const;
+};
+
+
+/**
+ * Get the global thread pool for the application.
+ *
+ * The pool is constructed on first use, so subcommands that do not use it
+ * do not pay for it. Call start() before the first task is submitted to set
+ * the pool parameters.
+ *
+ * @return thread pool
+ */
+inline ThreadPool& thread_pool() {
+    static ThreadPool instance;
+    return instance;
+}
+
+
+template <typename Func>
+std::future<std::invoke_result_t<std::decay_t<Func>&>> ThreadPool::submit(Func&& func) {
+    typedef std::invoke_result_t<std::decay_t<Func>&> Result;
+    // A packaged_task is move-only, but std::function must be copyable.
+    const auto task{std::make_shared<std::packaged_task<Result()>>(std::forward<Func>(func))};
+    auto future{task->get_future()};
+    push([task]() { (*task)(); });
+    return future;
+}
+
+
+template <typename T>
+T ThreadPool::wait(std::future<T>& future) {
+    join(future);
+    return future.get();
+}
+
+
+template <typename Index, typename Func>
+void ThreadPool::parallel_for(Index first, Index last, Func func, Index grain) {
+    static_assert(std::is_integral_v<Index>, "index must be an integer");
+    const auto chunk{static_cast<Index>(chunk_size(last > first ? last - first : 0, grain))};
+    std::vector<std::future<void>> futures;
+    for (auto begin{first}; begin < last; ) {
+        const auto end{static_cast<Index>(last - begin > chunk ? begin + chunk : last)};
+        futures.push_back(submit([&func, begin, end]() {
+            for (auto index{begin}; index < end; ++index) {
+                func(index);
+            }
+        }));
+        begin = end;
+    }
+    for (const auto& future: futures) {
+        // Wait for all chunks before rethrowing because they reference func.
+        join(future);
+    }
+    for (auto& future: futures) {
+        future.get();
+    }
+    return;
+}
+
+
+template <typename Index, typename T, typename Map, typename Reduce>
+T ThreadPool::parallel_reduce(Index first, Index last, T init, Map map, Reduce reduce, Index grain) {
+    static_assert(std::is_integral_v<Index>, "index must be an integer");
+    const auto chunk{static_cast<Index>(chunk_size(last > first ? last - first : 0, grain))};
+    std::vector<std::future<T>> futures;
+    for (auto begin{first}; begin < last; ) {
+        const auto end{static_cast<Index>(last - begin > chunk ? begin + chunk : last)};
+        futures.push_back(submit([&map, &reduce, begin, end]() {
+            T value(map(begin));
+            for (auto index{static_cast<Index>(begin + 1)}; index < end; ++index) {
+                value = reduce(std::move(value), map(index));
+            }
+            return value;
+        }));
+        begin = end;
+    }
+    for (const auto& future: futures) {
+        join(future);
+    }
+    for (auto& future: futures) {
+        init = reduce(std::move(init), future.get());
+    }
+    return init;
+}
+
+
+template <typename T>
+void ThreadPool::join(const std::future<T>& future) {
+    using namespace std::chrono_literals;
+    while (future.wait_for(0s) != std::future_status::ready) {
+        if (not run_pending()) {
+            future.wait_for(100us);
+        }
+    }
+    return;
+}
+
+#endif  // {{ cookiecutter.app_name|upper }}_THREADPOOL_HPP
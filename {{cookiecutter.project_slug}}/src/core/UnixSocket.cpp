@@ -0,0 +1,250 @@
+/**
+ * Implementation of the UnixSocket class.
+ */
+#include "UnixSocket.hpp"
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <system_error>
+#include <utility>
+
+using std::generic_category;
+using std::string;
+using std::system_error;
+
+namespace {  // internal linkage
+
+    /**
+     * Create a socket address for a path.
+     *
+     * @param path socket path
+     * @return socket address
+     */
+    sockaddr_un address(const std::filesystem::path& path) {
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        const auto& str{path.native()};
+        if (str.size() >= sizeof(addr.sun_path)) {
+            throw system_error{ENAMETOOLONG, generic_category(), "invalid socket path " + str};
+        }
+        std::memcpy(addr.sun_path, str.c_str(), str.size() + 1);
+        return addr;
+    }
+
+    /**
+     * Create a new socket.
+     *
+     * @return socket descriptor
+     */
+    int open_socket() {
+        const int fd{socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)};
+        if (fd == -1) {
+            throw system_error{errno, generic_category(), "cannot create socket"};
+        }
+        return fd;
+    }
+
+    /**
+     * Append a 32-bit integer to a message buffer.
+     *
+     * @param buffer message buffer
+     * @param value value to append
+     */
+    void append(string& buffer, std::uint32_t value) {
+        buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+        return;
+    }
+}
+
+
+UnixSocket UnixSocket::listen(const std::filesystem::path& path) {
+    const auto addr{address(path)};
+    if (std::filesystem::is_socket(path)) {
+        // Only replace a socket file that no server is listening on.
+        bool stale{false};
+        try {
+            connect(path);
+        }
+        catch (const system_error& ex) {
+            if (ex.code() != std::errc::connection_refused) {
+                throw;
+            }
+            stale = true;
+        }
+        if (not stale) {
+            throw system_error{EADDRINUSE, generic_category(), "server is already listening on " + path.string()};
+        }
+        std::filesystem::remove(path);
+    }
+    UnixSocket sock{open_socket()};
+    if (bind(sock.fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == -1) {
+        throw system_error{errno, generic_category(), "cannot bind " + path.string()};
+    }
+    sock.path = path;
+    if (::listen(sock.fd, SOMAXCONN) == -1) {
+        throw system_error{errno, generic_category(), "cannot listen on " + path.string()};
+    }
+    return sock;
+}
+
+
+UnixSocket UnixSocket::connect(const std::filesystem::path& path) {
+    const auto addr{address(path)};
+    UnixSocket sock{open_socket()};
+    if (::connect(sock.fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == -1) {
+        throw system_error{errno, generic_category(), "cannot connect to " + path.string()};
+    }
+    return sock;
+}
+
+
+UnixSocket::UnixSocket(int fd, std::filesystem::path path) :
+    fd{fd},
+    path{std::move(path)} {}
+
+
+UnixSocket::UnixSocket(UnixSocket&& other) noexcept :
+    fd{std::exchange(other.fd, -1)},
+    path{std::exchange(other.path, {})} {}
+
+
+UnixSocket::~UnixSocket() {
+    if (fd != -1) {
+        close(fd);
+    }
+    if (not path.empty()) {
+        std::error_code err;
+        std::filesystem::remove(path, err);  // ignore errors
+    }
+}
+
+
+UnixSocket UnixSocket::accept() const {
+    int client;
+    do {
+        client = ::accept4(fd, nullptr, nullptr, SOCK_CLOEXEC);
+    } while (client == -1 and errno == EINTR);
+    if (client == -1) {
+        throw system_error{errno, generic_category(), "cannot accept connection"};
+    }
+    return UnixSocket{client};
+}
+
+
+void UnixSocket::timeout(std::chrono::milliseconds timeout) const {
+    const auto usec{std::chrono::duration_cast<std::chrono::microseconds>(timeout).count()};
+    timeval value{};
+    value.tv_sec = static_cast<time_t>(usec / 1000000);
+    value.tv_usec = static_cast<suseconds_t>(usec % 1000000);
+    for (const auto option: {SO_RCVTIMEO, SO_SNDTIMEO}) {
+        if (setsockopt(fd, SOL_SOCKET, option, &value, sizeof(value)) == -1) {
+            throw system_error{errno, generic_category(), "cannot set socket timeout"};
+        }
+    }
+    return;
+}
+
+
+void UnixSocket::send(const Message& message) const {
+    size_t bytes{0};
+    for (const auto& str: message) {
+        bytes += str.size();
+    }
+    if (message.size() > max_strings or bytes > max_bytes) {
+        throw system_error{EMSGSIZE, generic_category(), "cannot send message"};
+    }
+    // Reuse the buffer so that sending does not allocate once it has grown
+    // to the typical message size.
+    thread_local string buffer;
+    buffer.clear();
+    buffer.reserve(sizeof(std::uint32_t) * (message.size() + 1) + bytes);
+    append(buffer, static_cast<std::uint32_t>(message.size()));
+    for (const auto& str: message) {
+        append(buffer, static_cast<std::uint32_t>(str.size()));
+        buffer += str;
+    }
+    write(buffer.data(), buffer.size());
+    return;
+}
+
+
+bool UnixSocket::recv(Message& message) const {
+    message.clear();
+    std::uint32_t count;
+    if (not read(&count, sizeof(count))) {
+        return false;
+    }
+    if (count > max_strings) {
+        throw system_error{EMSGSIZE, generic_category(), "cannot receive message"};
+    }
+    message.reserve(count);
+    size_t bytes{0};
+    for (std::uint32_t pos{0}; pos < count; ++pos) {
+        std::uint32_t size;
+        string str;
+        if (not read(&size, sizeof(size))) {
+            throw system_error{ECONNRESET, generic_category(), "incomplete message"};
+        }
+        bytes += size;
+        if (bytes > max_bytes) {
+            throw system_error{EMSGSIZE, generic_category(), "cannot receive message"};
+        }
+        str.resize(size);
+        if (size > 0 and not read(str.data(), size)) {
+            throw system_error{ECONNRESET, generic_category(), "incomplete message"};
+        }
+        message.push_back(std::move(str));
+    }
+    return true;
+}
+
+
+void UnixSocket::write(const void* data, size_t size) const {
+    auto ptr{static_cast<const char*>(data)};
+    while (size > 0) {
+        const auto count{::send(fd, ptr, size, MSG_NOSIGNAL)};
+        if (count == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN or errno == EWOULDBLOCK) {
+                throw system_error{ETIMEDOUT, generic_category(), "cannot send message"};
+            }
+            throw system_error{errno, generic_category(), "cannot send message"};
+        }
+        ptr += count;
+        size -= static_cast<size_t>(count);
+    }
+    return;
+}
+
+
+bool UnixSocket::read(void* data, size_t size) const {
+    auto ptr{static_cast<char*>(data)};
+    const auto total{size};
+    while (size > 0) {
+        const auto count{::recv(fd, ptr, size, 0)};
+        if (count == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN or errno == EWOULDBLOCK) {
+                throw system_error{ETIMEDOUT, generic_category(), "cannot receive message"};
+            }
+            throw system_error{errno, generic_category(), "cannot receive message"};
+        }
+        if (count == 0) {
+            if (size == total) {
+                return false;  // closed between messages
+            }
+            throw system_error{ECONNRESET, generic_category(), "incomplete message"};
+        }
+        ptr += count;
+        size -= static_cast<size_t>(count);
+    }
+    return true;
+}
@@ -0,0 +1,151 @@
+/**
+ * Header for the UnixSocket class.
+ *
+ * @file
+ */
+#ifndef {{ cookiecutter.app_name|upper }}_UNIXSOCKET_HPP
+#define {{ cookiecutter.app_name|upper }}_UNIXSOCKET_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+
+/**
+ * Stream socket in the Unix domain.
+ *
+ * Sockets exchange messages, where each message is a list of strings. This
+ * is sufficient for sending a command line and receiving its results. A
+ * message is encoded as a 32-bit string count followed by each string as a
+ * 32-bit length and its bytes. Integers use the native byte order because
+ * both ends of a Unix socket are on the same host.
+ *
+ * All errors cause a `std::system_error` exception. Messages larger than the
+ * limits below are an `EMSGSIZE` error, so a malformed header from one peer
+ * cannot exhaust memory.
+ */
+class UnixSocket {
+public:
+    /**
+     * A message is a list of strings.
+     */
+    typedef std::vector<std::string> Message;
+
+    /**
+     * Maximum number of strings in a message.
+     */
+    static constexpr std::size_t max_strings{4096};
+
+    /**
+     * Maximum total size of the strings in a message.
+     */
+    static constexpr std::size_t max_bytes{16 << 20};
+
+    /**
+     * Create a server socket.
+     *
+     * A stale socket file at `path` is removed first, but an `EADDRINUSE`
+     * error is thrown if another server is accepting connections on it. The
+     * socket file is removed when the object is destroyed.
+     *
+     * @param path socket path
+     * @return listening socket
+     */
+    static UnixSocket listen(const std::filesystem::path& path);
+
+    /**
+     * Create a client socket.
+     *
+     * @param path path of a listening socket
+     * @return connected socket
+     */
+    static UnixSocket connect(const std::filesystem::path& path);
+
+    /**
+     * Move constructor.
+     *
+     * @param other object to move from; it will no longer own a socket
+     */
+    UnixSocket(UnixSocket&& other) noexcept;
+
+    UnixSocket(const UnixSocket&) = delete;
+    UnixSocket& operator=(const UnixSocket&) = delete;
+
+    /**
+     * Close the socket.
+     */
+    ~UnixSocket();
+
+    /**
+     * Accept a client connection.
+     *
+     * This blocks until a client connects to this server socket.
+     *
+     * @return connected socket
+     */
+    UnixSocket accept() const;
+
+    /**
+     * Limit the time that send() and recv() can block.
+     *
+     * A call that is blocked for longer than this without any progress is an
+     * `ETIMEDOUT` error, e.g. if the peer is idle. Sockets have no limit by
+     * default.
+     *
+     * @param timeout time limit; 0 for no limit
+     */
+    void timeout(std::chrono::milliseconds timeout) const;
+
+    /**
+     * Send a message.
+     *
+     * The message is encoded into a buffer and sent with a single system call
+     * if the socket buffer has room.
+     *
+     * @param message message to send
+     */
+    void send(const Message& message) const;
+
+    /**
+     * Receive a message.
+     *
+     * This blocks until an entire message is received.
+     *
+     * @param message received message
+     * @return false if the peer closed the connection
+     */
+    bool recv(Message& message) const;
+
+private:
+    int fd;
+    std::filesystem::path path;  // socket file to remove; empty for clients
+
+    /**
+     * Construct an object that owns a socket.
+     *
+     * @param fd socket descriptor
+     * @param path socket file to remove
+     */
+    explicit UnixSocket(int fd, std::filesystem::path path={});
+
+    /**
+     * Send bytes.
+     *
+     * @param data data to send
+     * @param size number of bytes to send
+     */
+    void write(const void* data, size_t size) const;
+
+    /**
+     * Receive bytes.
+     *
+     * @param data buffer for received data
+     * @param size number of bytes to receive
+     * @return false if the peer closed the connection before any data
+     */
+    bool read(void* data, size_t size) const;
+};
+
+#endif  // {{ cookiecutter.app_name|upper }}_UNIXSOCKET_HPP
@@ -0,0 +1,491 @@
+/**
+ * Implementation of the async I/O module.
+ */
+#include "async.hpp"
+#include "ThreadPool.hpp"
+#include <linux/io_uring.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <iterator>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+
+using std::generic_category;
+using std::system_error;
+
+namespace async {
+
+    /**
+     * Abstract base class for I/O backends.
+     */
+    class Driver {
+    public:
+        virtual ~Driver() = default;
+
+        /**
+         * Get the backend name.
+         *
+         * @return name
+         */
+        virtual const char* name() const = 0;
+
+        /**
+         * Start an operation.
+         *
+         * @param op operation; it must remain valid until it is complete
+         */
+        virtual void submit(Operation& op) = 0;
+
+        /**
+         * Wait for at least one operation to complete.
+         *
+         * @return completed operations
+         */
+        virtual std::vector<Operation*> wait() = 0;
+
+        /**
+         * Get the number of operations in progress.
+         *
+         * @return operation count
+         */
+        size_t pending() const { return count; }
+
+    protected:
+        size_t count{0};
+    };
+}
+
+
+namespace {  // internal linkage
+
+    using async::Driver;
+    using async::Operation;
+
+    /**
+     * I/O backend using io_uring.
+     *
+     * This uses the io_uring system calls directly, so liburing is not
+     * required.
+     */
+    class UringDriver: public Driver {
+    public:
+        /**
+         * Create a ring.
+         *
+         * @param entries submission queue size
+         */
+        explicit UringDriver(unsigned entries=256) {
+            io_uring_params params{};
+            fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+            if (fd == -1) {
+                throw system_error{errno, generic_category(), "io_uring is not available"};
+            }
+            if (not (params.features & IORING_FEAT_RW_CUR_POS)) {
+                // Kernel is too old for IORING_OP_READ and IORING_OP_WRITE.
+                close(fd);
+                throw system_error{ENOSYS, generic_category(), "io_uring is not supported"};
+            }
+            sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            const bool single{(params.features & IORING_FEAT_SINGLE_MMAP) != 0};
+            if (single) {
+                sq_size = cq_size = std::max(sq_size, cq_size);
+            }
+            sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+            try {
+                sq_ring = map(sq_size, IORING_OFF_SQ_RING);
+                cq_ring = single ? sq_ring : map(cq_size, IORING_OFF_CQ_RING);
+                sqes = static_cast<io_uring_sqe*>(map(sqes_size, IORING_OFF_SQES));
+            }
+            catch (...) {
+                release();
+                throw;
+            }
+            const auto sq{static_cast<char*>(sq_ring)};
+            sq_head = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+            sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+            sq_mask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+            sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+            sq_entries = params.sq_entries;
+            const auto cq{static_cast<char*>(cq_ring)};
+            cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+            cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+            cq_mask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+            cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        }
+
+        UringDriver(const UringDriver&) = delete;
+        UringDriver& operator=(const UringDriver&) = delete;
+
+        ~UringDriver() override {
+            release();
+        }
+
+        const char* name() const override {
+            return "io_uring";
+        }
+
+        void submit(Operation& op) override {
+            const auto tail{*sq_tail};  // only written by this thread
+            if (tail - std::atomic_ref{*sq_head}.load(std::memory_order_acquire) == sq_entries) {
+                enter(0);  // queue is full
+            }
+            const auto index{tail & sq_mask};
+            auto& sqe{sqes[index]};
+            std::memset(&sqe, 0, sizeof(sqe));
+            sqe.opcode = op.code == Operation::READ ? IORING_OP_READ : IORING_OP_WRITE;
+            sqe.fd = op.fd;
+            sqe.addr = reinterpret_cast<std::uintptr_t>(op.data);
+            sqe.len = static_cast<unsigned>(op.size);
+            sqe.off = static_cast<std::uint64_t>(op.offset);  // -1 for current position
+            sqe.user_data = reinterpret_cast<std::uintptr_t>(&op);
+            sq_array[index] = index;
+            std::atomic_ref{*sq_tail}.store(tail + 1, std::memory_order_release);
+            ++unsubmitted;
+            ++count;
+            return;
+        }
+
+        std::vector<Operation*> wait() override {
+            enter(1);
+            std::vector<Operation*> complete;
+            auto head{*cq_head};  // only written by this thread
+            const auto tail{std::atomic_ref{*cq_tail}.load(std::memory_order_acquire)};
+            for (; head != tail; ++head) {
+                const auto& cqe{cqes[head & cq_mask]};
+                const auto op{reinterpret_cast<Operation*>(cqe.user_data)};
+                op->result = cqe.res;
+                complete.push_back(op);
+            }
+            std::atomic_ref{*cq_head}.store(head, std::memory_order_release);
+            count -= complete.size();
+            return complete;
+        }
+
+    private:
+        int fd;
+        void* sq_ring{nullptr};
+        void* cq_ring{nullptr};
+        io_uring_sqe* sqes{nullptr};
+        size_t sq_size;
+        size_t cq_size;
+        size_t sqes_size;
+        unsigned* sq_head;
+        unsigned* sq_tail;
+        unsigned* sq_array;
+        unsigned sq_mask;
+        unsigned sq_entries;
+        unsigned* cq_head;
+        unsigned* cq_tail;
+        unsigned cq_mask;
+        io_uring_cqe* cqes;
+        unsigned unsubmitted{0};
+
+        /**
+         * Unmap the ring buffers and close the ring.
+         */
+        void release() noexcept {
+            if (sqes) {
+                munmap(sqes, sqes_size);
+            }
+            if (cq_ring and cq_ring != sq_ring) {
+                munmap(cq_ring, cq_size);
+            }
+            if (sq_ring) {
+                munmap(sq_ring, sq_size);
+            }
+            close(fd);
+            return;
+        }
+
+        /**
+         * Map a ring buffer.
+         *
+         * @param size buffer size
+         * @param offset buffer identifier
+         * @return mapped address
+         */
+        void* map(size_t size, off_t offset) {
+            const auto addr{mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset)};
+            if (addr == MAP_FAILED) {
+                throw system_error{errno, generic_category(), "could not map io_uring"};
+            }
+            return addr;
+        }
+
+        /**
+         * Submit queued operations and optionally wait for completions.
+         *
+         * @param min_complete number of completions to wait for
+         */
+        void enter(unsigned min_complete) {
+            const unsigned flags{min_complete > 0 ? IORING_ENTER_GETEVENTS : 0u};
+            for (;;) {
+                const auto submitted{syscall(__NR_io_uring_enter, fd, unsubmitted, min_complete, flags, nullptr, 0)};
+                if (submitted >= 0) {
+                    unsubmitted -= static_cast<unsigned>(submitted);
+                    return;
+                }
+                if (errno != EINTR) {
+                    throw system_error{errno, generic_category(), "io_uring_enter failed"};
+                }
+            }
+        }
+    };
+
+
+    /**
+     * I/O backend using epoll and the thread pool.
+     *
+     * Streams are polled for readiness, and regular files are handled by the
+     * global thread pool. Completed pool operations are queued and signaled
+     * with an eventfd.
+     */
+    class EpollDriver: public Driver {
+    public:
+        EpollDriver() :
+            epfd{epoll_create1(EPOLL_CLOEXEC)},
+            evfd{eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)} {
+            if (epfd == -1 or evfd == -1) {
+                throw system_error{errno, generic_category(), "could not create epoll instance"};
+            }
+            epoll_event event{};
+            event.events = EPOLLIN;
+            event.data.ptr = nullptr;  // identifies evfd
+            if (epoll_ctl(epfd, EPOLL_CTL_ADD, evfd, &event) == -1) {
+                throw system_error{errno, generic_category(), "could not add eventfd"};
+            }
+        }
+
+        EpollDriver(const EpollDriver&) = delete;
+        EpollDriver& operator=(const EpollDriver&) = delete;
+
+        ~EpollDriver() override {
+            // Wait for operations still running in the thread pool, since
+            // they reference this object.
+            while (inflight > 0) {
+                std::this_thread::yield();
+            }
+            close(evfd);
+            close(epfd);
+        }
+
+        const char* name() const override {
+            return "epoll";
+        }
+
+        void submit(Operation& op) override {
+            struct stat info;
+            if (fstat(op.fd, &info) == -1) {
+                throw system_error{errno, generic_category(), "invalid file descriptor"};
+            }
+            ++count;
+            if (S_ISREG(info.st_mode) or S_ISBLK(info.st_mode)) {
+                ++inflight;
+                thread_pool().submit([this, &op]() {
+                    transfer(op);
+                    {
+                        const std::lock_guard<std::mutex> lock{mutex};
+                        done.push_back(&op);
+                    }
+                    const std::uint64_t one{1};
+                    static_cast<void>(::write(evfd, &one, sizeof(one)));
+                    --inflight;
+                });
+                return;
+            }
+            auto& watch{watches[op.fd]};
+            (op.code == Operation::READ ? watch.reader : watch.writer) = &op;
+            update(op.fd, watch);
+            return;
+        }
+
+        std::vector<Operation*> wait() override {
+            std::vector<Operation*> complete;
+            epoll_event events[64];
+            int ready;
+            do {
+                ready = epoll_wait(epfd, events, 64, -1);
+            } while (ready == -1 and errno == EINTR);
+            if (ready == -1) {
+                throw system_error{errno, generic_category(), "epoll_wait failed"};
+            }
+            for (int pos{0}; pos < ready; ++pos) {
+                const auto& event{events[pos]};
+                if (event.data.ptr == nullptr) {
+                    std::uint64_t value;
+                    static_cast<void>(::read(evfd, &value, sizeof(value)));
+                    const std::lock_guard<std::mutex> lock{mutex};
+                    complete.insert(complete.end(), done.begin(), done.end());
+                    done.clear();
+                    continue;
+                }
+                const auto fd{static_cast<int>(reinterpret_cast<std::intptr_t>(event.data.ptr) - 1)};
+                auto& watch{watches[fd]};
+                const auto error{(event.events & (EPOLLERR | EPOLLHUP)) != 0};
+                if (watch.reader and ((event.events & EPOLLIN) or error)) {
+                    transfer(*watch.reader);
+                    complete.push_back(std::exchange(watch.reader, nullptr));
+                }
+                if (watch.writer and ((event.events & EPOLLOUT) or error)) {
+                    transfer(*watch.writer);
+                    complete.push_back(std::exchange(watch.writer, nullptr));
+                }
+                update(fd, watch);
+            }
+            count -= complete.size();
+            return complete;
+        }
+
+    private:
+        struct Watch {
+            Operation* reader{nullptr};
+            Operation* writer{nullptr};
+            bool added{false};
+        };
+
+        int epfd;
+        int evfd;
+        std::unordered_map<int, Watch> watches;
+        std::mutex mutex;  // guards done
+        std::vector<Operation*> done;
+        std::atomic<size_t> inflight{0};
+
+        /**
+         * Update the epoll interest list for a stream.
+         *
+         * @param fd file descriptor
+         * @param watch waiting operations for the stream
+         */
+        void update(int fd, Watch& watch) {
+            epoll_event event{};
+            event.events = (watch.reader ? EPOLLIN : 0u) | (watch.writer ? EPOLLOUT : 0u);
+            event.data.ptr = reinterpret_cast<void*>(static_cast<std::intptr_t>(fd) + 1);  // nullptr is evfd
+            int status{0};
+            if (event.events == 0) {
+                if (watch.added) {
+                    status = epoll_ctl(epfd, EPOLL_CTL_DEL, fd, nullptr);
+                }
+                watches.erase(fd);
+            }
+            else {
+                status = epoll_ctl(epfd, watch.added ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, fd, &event);
+                watch.added = true;
+            }
+            if (status == -1) {
+                throw system_error{errno, generic_category(), "could not poll file descriptor"};
+            }
+            return;
+        }
+
+        /**
+         * Execute an operation with a blocking system call.
+         *
+         * @param op operation
+         */
+        static void transfer(Operation& op) {
+            ssize_t result;
+            if (op.code == Operation::READ) {
+                result = op.offset < 0 ? ::read(op.fd, op.data, op.size) : pread(op.fd, op.data, op.size, op.offset);
+            }
+            else {
+                result = op.offset < 0 ? ::write(op.fd, op.data, op.size) : pwrite(op.fd, op.data, op.size, op.offset);
+            }
+            op.result = result == -1 ? -errno : result;
+            return;
+        }
+    };
+}
+
+
+using namespace async;
+
+
+void IoRequest::await_suspend(std::coroutine_handle<> handle) {
+    op.handle = handle;
+    driver.submit(op);
+    return;
+}
+
+
+size_t IoRequest::await_resume() const {
+    if (op.result < 0) {
+        throw system_error{static_cast<int>(-op.result), generic_category(), "I/O operation failed"};
+    }
+    return static_cast<size_t>(op.result);
+}
+
+
+EventLoop::EventLoop(bool uring) {
+    if (uring) {
+        try {
+            driver = std::make_unique<UringDriver>();
+        }
+        catch (const system_error&) {
+            // Use the fallback backend.
+        }
+    }
+    if (not driver) {
+        driver = std::make_unique<EpollDriver>();
+    }
+}
+
+
+EventLoop::~EventLoop() = default;
+
+
+const char* EventLoop::backend() const {
+    return driver->name();
+}
+
+
+IoRequest EventLoop::read(int fd, void* buffer, size_t size, std::int64_t offset) {
+    return {*driver, {Operation::READ, fd, buffer, size, offset, 0, {}}};
+}
+
+
+IoRequest EventLoop::write(int fd, const void* data, size_t size, std::int64_t offset) {
+    return {*driver, {Operation::WRITE, fd, const_cast<void*>(data), size, offset, 0, {}}};
+}
+
+
+void EventLoop::spawn(Task<> task) {
+    task.handle.resume();
+    spawned.push_back(std::move(task));
+    return;
+}
+
+
+bool EventLoop::poll() {
+    if (driver->pending() == 0) {
+        return false;
+    }
+    for (const auto op: driver->wait()) {
+        op->handle.resume();
+    }
+    return true;
+}
+
+
+void EventLoop::reap() {
+    const auto iter{std::partition(spawned.begin(), spawned.end(), [](const Task<>& task) {
+        return not task.done();
+    })};
+    std::vector<Task<>> finished;
+    std::move(iter, spawned.end(), std::back_inserter(finished));
+    spawned.erase(iter, spawned.end());
+    for (auto& task: finished) {
+        task.handle.promise().get();  // rethrow any exception
+    }
+    return;
+}
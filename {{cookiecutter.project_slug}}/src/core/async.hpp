@@ -0,0 +1,347 @@
+/**
+ * Header for the async I/O module.
+ *
+ * This requires C++20 coroutines, so it is only built if the BUILD_ASYNC
+ * CMake option is enabled.
+ *
+ * @file
+ */
+#ifndef {{ cookiecutter.app_name|upper }}_ASYNC_HPP
+#define {{ cookiecutter.app_name|upper }}_ASYNC_HPP
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+
+namespace async {
+
+    template <typename T=void>
+    class Task;
+
+    class EventLoop;
+
+    /**
+     * Common coroutine promise behavior for all Task types.
+     *
+     * Tasks are lazy; a task does not start until it is awaited or run by an
+     * EventLoop. When it finishes, control is transferred directly to the
+     * awaiting coroutine.
+     */
+    class PromiseBase {
+    public:
+        /**
+         * Transfer control to the awaiting coroutine at completion.
+         */
+        struct FinalAwaiter {
+            bool await_ready() const noexcept { return false; }
+
+            template <typename Promise>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+                const auto next{handle.promise().continuation};
+                return next ? next : std::noop_coroutine();
+            }
+
+            void await_resume() const noexcept {}
+        };
+
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+
+        FinalAwaiter final_suspend() const noexcept { return {}; }
+
+        void unhandled_exception() noexcept { error = std::current_exception(); }
+
+        std::coroutine_handle<> continuation;
+
+    protected:
+        std::exception_ptr error;
+
+        /**
+         * Rethrow an exception from the coroutine body.
+         */
+        void rethrow() const {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    };
+
+    /**
+     * Coroutine promise for a Task that returns a value.
+     */
+    template <typename T>
+    class Promise: public PromiseBase {
+    public:
+        Task<T> get_return_object() noexcept;
+
+        template <typename U>
+        void return_value(U&& value) { result.emplace(std::forward<U>(value)); }
+
+        /**
+         * Get the coroutine result.
+         *
+         * @return returned value
+         */
+        T get() {
+            rethrow();
+            return std::move(*result);
+        }
+
+    private:
+        std::optional<T> result;
+    };
+
+    /**
+     * Coroutine promise for a Task that does not return a value.
+     */
+    template <>
+    class Promise<void>: public PromiseBase {
+    public:
+        Task<void> get_return_object() noexcept;
+
+        void return_void() const noexcept {}
+
+        /**
+         * Get the coroutine result.
+         */
+        void get() const { rethrow(); }
+    };
+
+    /**
+     * Coroutine result type.
+     *
+     * A coroutine that returns `Task<T>` uses `co_return` to return a value
+     * of type `T`, and it may `co_await` other tasks and I/O requests.
+     * Exceptions are propagated to the awaiting coroutine.
+     */
+    template <typename T>
+    class Task {
+    public:
+        typedef Promise<T> promise_type;
+
+        /**
+         * Move constructor.
+         *
+         * @param other task to move from; it will no longer own a coroutine
+         */
+        Task(Task&& other) noexcept :
+            handle{std::exchange(other.handle, {})} {}
+
+        /**
+         * Move assignment.
+         *
+         * @param other task to move from; it will no longer own a coroutine
+         * @return this task
+         */
+        Task& operator=(Task&& other) noexcept {
+            if (this != &other) {
+                destroy();
+                handle = std::exchange(other.handle, {});
+            }
+            return *this;
+        }
+
+        /**
+         * Destroy the coroutine.
+         */
+        ~Task() { destroy(); }
+
+        /**
+         * Determine if the coroutine has finished.
+         *
+         * @return true if the coroutine is done
+         */
+        bool done() const noexcept { return not handle or handle.done(); }
+
+        bool await_ready() const noexcept { return false; }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept {
+            handle.promise().continuation = caller;
+            return handle;
+        }
+
+        T await_resume() { return handle.promise().get(); }
+
+    private:
+        friend class Promise<T>;
+        friend class EventLoop;
+
+        std::coroutine_handle<promise_type> handle;
+
+        explicit Task(std::coroutine_handle<promise_type> handle) noexcept :
+            handle{handle} {}
+
+        void destroy() noexcept {
+            if (handle) {
+                handle.destroy();
+            }
+        }
+    };
+
+    template <typename T>
+    Task<T> Promise<T>::get_return_object() noexcept {
+        return Task<T>{std::coroutine_handle<Promise>::from_promise(*this)};
+    }
+
+    inline Task<void> Promise<void>::get_return_object() noexcept {
+        return Task<void>{std::coroutine_handle<Promise>::from_promise(*this)};
+    }
+
+    /**
+     * An I/O operation.
+     */
+    struct Operation {
+        enum Code { READ, WRITE };
+        Code code;
+        int fd;
+        void* data;
+        size_t size;
+        std::int64_t offset;  // -1 for the current position or a stream
+        std::int64_t result;  // byte count or negative error number
+        std::coroutine_handle<> handle;  // resumed at completion
+    };
+
+    class Driver;
+
+    /**
+     * Awaitable I/O request.
+     *
+     * The awaiting coroutine is resumed by the event loop when the operation
+     * is complete, and `co_await` returns the number of bytes transferred.
+     * Errors cause a `std::system_error` exception.
+     */
+    class IoRequest {
+    public:
+        bool await_ready() const noexcept { return false; }
+
+        void await_suspend(std::coroutine_handle<> handle);
+
+        size_t await_resume() const;
+
+    private:
+        friend class EventLoop;
+
+        Driver& driver;
+        Operation op;
+
+        IoRequest(Driver& driver, const Operation& op) :
+            driver{driver},
+            op{op} {}
+    };
+
+    /**
+     * Single-threaded coroutine event loop.
+     *
+     * I/O requests use io_uring if the kernel supports it. Otherwise, streams
+     * such as sockets and pipes are polled with epoll, and regular files are
+     * read and written by the global thread pool, because epoll does not
+     * support them. Coroutines are always resumed on the thread that called
+     * run().
+     */
+    class EventLoop {
+    public:
+        /**
+         * Construct an event loop.
+         *
+         * @param uring use io_uring if it is available
+         */
+        explicit EventLoop(bool uring=true);
+
+        EventLoop(const EventLoop&) = delete;
+        EventLoop& operator=(const EventLoop&) = delete;
+
+        /**
+         * Destroy the event loop.
+         */
+        ~EventLoop();
+
+        /**
+         * Get the name of the I/O backend.
+         *
+         * @return "io_uring" or "epoll"
+         */
+        const char* backend() const;
+
+        /**
+         * Read from a file descriptor.
+         *
+         * @param fd file descriptor
+         * @param buffer destination buffer
+         * @param size maximum number of bytes to read
+         * @param offset file offset, or -1 to read from the current position
+         * @return awaitable request
+         */
+        IoRequest read(int fd, void* buffer, size_t size, std::int64_t offset=-1);
+
+        /**
+         * Write to a file descriptor.
+         *
+         * @param fd file descriptor
+         * @param data data to write
+         * @param size number of bytes to write
+         * @param offset file offset, or -1 to write at the current position
+         * @return awaitable request
+         */
+        IoRequest write(int fd, const void* data, size_t size, std::int64_t offset=-1);
+
+        /**
+         * Start a task that runs concurrently with the caller.
+         *
+         * The task is owned by the loop, and run() does not return until all
+         * spawned tasks are complete.
+         *
+         * @param task task to start
+         */
+        void spawn(Task<> task);
+
+        /**
+         * Run a task to completion.
+         *
+         * @param task task to run
+         * @return task result
+         */
+        template <typename T>
+        T run(Task<T> task);
+
+    private:
+        std::unique_ptr<Driver> driver;
+        std::vector<Task<>> spawned;
+
+        /**
+         * Wait for I/O completions and resume the awaiting coroutines.
+         *
+         * @return false if there are no pending operations
+         */
+        bool poll();
+
+        /**
+         * Remove completed spawned tasks.
+         *
+         * Any exception from a spawned task is rethrown here.
+         */
+        void reap();
+    };
+
+    template <typename T>
+    T EventLoop::run(Task<T> task) {
+        task.handle.resume();
+        while (not task.done() or not spawned.empty()) {
+            reap();
+            if (task.done() and spawned.empty()) {
+                break;
+            }
+            if (not poll()) {
+                throw std::logic_error("tasks are waiting but no I/O is pending");
+            }
+        }
+        return task.handle.promise().get();
+    }
+}
+
+#endif  // {{ cookiecutter.app_name|upper }}_ASYNC_HPP
@@ -2,11 +2,18 @@
  * Implementation of the configure module.
  */
 #include "configure.hpp"
+#include "MappedFile.hpp"
 #include <toml++/toml.h>
 #include <cctype>
+#include <charconv>
+#include <cstdint>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
 #include <istream>
+#include <limits>
+#include <locale>
+#include <sstream>
 #include <stdexcept>
 
 
@@ -15,6 +22,7 @@ using std::ifstream;
 using std::invalid_argument;
 using std::isspace;
 using std::istream;
+using std::ostringstream;
 using std::out_of_range;
 using std::runtime_error;
 using std::skipws;
@@ -24,6 +32,91 @@ using std::to_string;
 using namespace configure;
 
 
+namespace {  // internal linkage
+
+    /**
+     * Format a TOML float.
+     *
+     * The result can be parsed by numeric::parse() without loss.
+     *
+     * @param value float value
+     * @return shortest text that round trips
+     */
+    string format(double value) {
+#if defined(__cpp_lib_to_chars)
+        char buffer[32];
+        const auto [ptr, err]{std::to_chars(buffer, buffer + sizeof(buffer), value)};
+        return {buffer, ptr};
+#else
+        ostringstream stream;
+        stream.imbue(std::locale::classic());
+        stream << std::setprecision(std::numeric_limits<double>::max_digits10) << value;
+        return stream.str();
+#endif
+    }
+
+    /**
+     * Insert a table element into a Config object.
+     *
+     * Nested tables are inserted recursively using dotted components for the
+     * key name, *e.g.* "root.nested.value". Scalar values are stored as the
+     * text that configure::Schema fields parse, *e.g.* `true` or `1.5`, and
+     * other value types are rejected. This is the only code that uses the
+     * TOML library, so it is confined to this file.
+     *
+     * @param config config to update
+     * @param root key that designates the root of this table; this is used as
+     *   a buffer for nested keys, and it is restored on return
+     * @param table TOML table element
+     */
+    void insert(Config& config, string& root, const toml::table& table) {
+        const auto size{root.size()};
+        for (auto&& [key, node] : table) {
+            // Build the dotted key in place to avoid temporary strings.
+            root.resize(size);
+            if (size != 0) {
+                root += '.';
+            }
+            root += key.str();
+            switch (node.type()) {
+            case toml::node_type::table:
+                insert(config, root, *node.as_table());
+                break;
+            case toml::node_type::string:
+                config[root] = node.value_or("");
+                break;
+            case toml::node_type::integer:
+                config[root] = to_string(*node.value<std::int64_t>());
+                break;
+            case toml::node_type::floating_point:
+                config[root] = format(*node.value<double>());
+                break;
+            case toml::node_type::boolean:
+                config[root] = *node.value<bool>() ? "true" : "false";
+                break;
+            default:
+                // Arrays, dates, and times.
+                throw invalid_argument{"unsupported TOML value for '" + root + "'"};
+            }
+        }
+        root.resize(size);
+        return;
+    }
+
+    /**
+     * Insert the root table of a TOML document into a Config object.
+     *
+     * @param config config to update
+     * @param table TOML table element
+     */
+    void insert(Config& config, const toml::table& table) {
+        string root;
+        insert(config, root, table);
+        return;
+    }
+}
+
+
 Config::Config(istream& stream) {
     load(stream);
 }
@@ -35,47 +128,51 @@ Config::Config(const std::string& path) {
 
 
 void Config::load(istream& stream) {
-    insert("", toml::parse(stream));
+    insert(*this, toml::parse(stream));
+    update();
 }
 
 
 void Config::load(const std::filesystem::path& path) {
-    insert("", toml::parse_file(path.string()));
+    const MappedFile file{path};
+    insert(*this, toml::parse(file.view(), path.string()));
+    update();
+}
+
+
+void Config::load_text(std::string_view text) {
+    insert(*this, toml::parse(text));
+    update();
 }
 
 
 string& Config::operator[](const string& key) {
-    return data[key];
+    auto iter{data.find(key)};
+    if (iter == data.end()) {
+        iter = data.emplace(std::string_view{key}, string{}).first;
+    }
+    return iter->second;
 }
     
 
 const string& Config::operator[](const string& key) const {
-    try {
-        return data.at(key);
-    }
-    catch (out_of_range&) {
+    const auto iter{data.find(key)};
+    if (iter == data.end()) {
         throw out_of_range("no value for '" + key + "'");
     }
+    return iter->second;
 }
 
 
-void Config::insert(const std::string root, const toml::table& table) {
-    for (auto&& [key, node] : table) {
-        string path_key = string{key.str()};
-        if (root != "") {
-            path_key = root + "." + path_key;
-        }
-        if (node.is_value()) {
-            data[path_key] = node.value_or("");
-        }
-        else if (node.is_table()) {
-            insert(path_key, *node.as_table());
-        }
-        else {
-            throw invalid_argument{"unexpected TOML node type"};
-        }
+std::pmr::string Config::get(const string& key, std::pmr::memory_resource* resource) const {
+    const auto& value{(*this)[key]};
+    return {value.data(), value.size(), resource};
+}
+
+
+void Config::update() {
+    for (const auto& bind: bindings) {
+        bind(*this);
     }
     return;
 }
-
-Config configure::config;
@@ -9,14 +9,114 @@
 #ifndef {{ cookiecutter.app_name|upper }}_CONFIGURE_HPP
 #define {{ cookiecutter.app_name|upper }}_CONFIGURE_HPP
 
-#include <toml++/toml.h>
 #include <filesystem>
+#include <functional>
 #include <istream>
 #include <map>
+#include <memory_resource>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+#include "numeric.hpp"
 
 
 namespace configure {
+    /**
+     * Convert a config value to a typed value.
+     *
+     * This is the default conversion used for bound struct members, and it
+     * supports strings, booleans ("true" or "false"), and arithmetic types.
+     * A `std::invalid_argument` exception is thrown if the value cannot be
+     * converted.
+     *
+     * @tparam T value type
+     * @param str config value
+     * @return converted value
+     */
+    template <typename T>
+    T parse(const std::string& str);
+
+    /**
+     * Bind a struct member to a config key.
+     *
+     * This is created by field(), and it is used to define a Schema.
+     *
+     * @tparam T struct type
+     * @tparam M member type
+     * @tparam Parse callable that converts a string to M
+     */
+    template <typename T, typename M, typename Parse>
+    struct Field {
+        const char* key;
+        M T::* member;
+        Parse convert;
+    };
+
+    /**
+     * Default conversion for a Field.
+     *
+     * @tparam M member type
+     */
+    template <typename M>
+    struct Parser {
+        M operator()(const std::string& str) const {
+            return parse<M>(str);
+        }
+    };
+
+    /**
+     * Bind a struct member to a config key using the default conversion.
+     *
+     * @param key hierarchical element key, *e.g.* "table.nested.value"
+     * @param member pointer to the struct member
+     * @return new field
+     */
+    template <typename T, typename M>
+    constexpr Field<T, M, Parser<M>> field(const char* key, M T::* member) {
+        return {key, member, Parser<M>{}};
+    }
+
+    /**
+     * Bind a struct member to a config key using a custom conversion.
+     *
+     * @param key hierarchical element key, *e.g.* "table.nested.value"
+     * @param member pointer to the struct member
+     * @param convert callable that converts a string to the member type
+     * @return new field
+     */
+    template <typename T, typename M, typename Parse>
+    constexpr Field<T, M, Parse> field(const char* key, M T::* member, Parse convert) {
+        return {key, member, convert};
+    }
+
+    /**
+     * Define the config fields for a settings struct.
+     *
+     * This must be specialized for every struct that is used with
+     * Config::get() or Config::bind(). The specialization defines a
+     * `constexpr` tuple of fields that maps struct members to config keys:
+     *
+     *     struct LoggingSettings {
+     *         Logging::Level level;
+     *         std::string format;
+     *     };
+     *
+     *     template <>
+     *     struct configure::Schema<LoggingSettings> {
+     *         static constexpr auto fields{std::make_tuple(
+     *             field("logging.level", &LoggingSettings::level, to_level),
+     *             field("logging.format", &LoggingSettings::format)
+     *         )};
+     *     };
+     *
+     * @tparam T settings struct type
+     */
+    template <typename T>
+    struct Schema;
+
     /**
      * Store application config data.
      */
@@ -27,6 +127,9 @@ namespace configure {
          */
         Config() = default;
 
+        Config(const Config&) = delete;
+        Config& operator=(const Config&) = delete;
+
         /**
          * Construct a Config object from an input stream.
          *
@@ -54,10 +157,22 @@ namespace configure {
         /**
          * Load config data from a file path.
          *
+         * The file is memory mapped and parsed in place.
+         *
          * @param path TOML file path
          */
         void load(const std::filesystem::path& path);
 
+        /**
+         * Load config data from a string.
+         *
+         * This is intended for config data that is embedded in the
+         * application, *e.g.* default values.
+         *
+         * @param text TOML data
+         */
+        void load_text(std::string_view text);
+
         /**
          * Access a writable config value.
          *
@@ -82,24 +197,137 @@ namespace configure {
          * @param section section name; defaults to the root section
          */
         const std::string& operator[](const std::string& key) const;
-        
-    private:
-        typedef std::map<std::string, std::string> ValueMap;
-        ValueMap data;
 
         /**
-         * Insert a table element into the data structure.
+         * Copy a config value into a memory resource.
          *
-         * Nested tables are inserted recursively using dotted components for
-         * the key name, *e.g.* "root.nested.value".
+         * This is the same as the const operator[], but the copy can be
+         * allocated from a short-lived arena, e.g. `Arena::current()`.
          *
-         * @param root key that designates the root of this table
-         * @param table TOML table element
+         * @param key hierarchical element key
+         * @param resource memory resource for the result
+         * @return value
+         */
+        std::pmr::string get(const std::string& key, std::pmr::memory_resource* resource) const;
+
+        /**
+         * Create a settings struct from config values.
+         *
+         * Every field defined by `Schema<T>` is converted and assigned to the
+         * new struct. A `std::out_of_range` exception is thrown if a key does
+         * not exist, and a `std::invalid_argument` exception is thrown if a
+         * value cannot be converted.
+         *
+         * @tparam T settings struct type
+         * @return new settings struct
+         */
+        template <typename T>
+        T get() const;
+
+        /**
+         * Bind a settings struct to this object.
+         *
+         * The struct is filled immediately as if by get(), and again every
+         * time config data is loaded. Clients can then read plain struct
+         * members instead of looking up config values. The struct is left
+         * unmodified if any value is invalid. The struct must outlive this
+         * object.
+         *
+         * @tparam T settings struct type
+         * @param target struct to bind
          */
-        void insert(const std::string root, const toml::table& table);
+        template <typename T>
+        void bind(T& target);
+
+    private:
+        /**
+         * Compare keys of any string type.
+         */
+        struct KeyLess {
+            typedef void is_transparent;
+            bool operator()(std::string_view lhs, std::string_view rhs) const {
+                return lhs < rhs;
+            }
+        };
+
+        // Keys and map nodes are allocated from a single arena that is
+        // released all at once. Keys are never erased, so nothing is wasted.
+        // Values are standard strings because they are writable by clients.
+        typedef std::pmr::map<std::pmr::string, std::string, KeyLess> ValueMap;
+        std::pmr::monotonic_buffer_resource arena;
+        ValueMap data{&arena};
+        std::vector<std::function<void(const Config&)>> bindings;
+
+        /**
+         * Fill all bound structs from the current config values.
+         */
+        void update();
     };
 
-    extern Config config;
+    /**
+     * Get the application config.
+     *
+     * The config is constructed empty on first use, so it is safe to use from
+     * static initializers in other translation units. Loading values is not
+     * thread-safe.
+     *
+     * @return config
+     */
+    inline Config& config() {
+        static Config instance;
+        return instance;
+    }
+
+
+    template <typename T>
+    T parse(const std::string& str) {
+        if constexpr (std::is_same_v<T, std::string>) {
+            return str;
+        }
+        else if constexpr (std::is_same_v<T, bool>) {
+            if (str == "true") {
+                return true;
+            }
+            else if (str == "false") {
+                return false;
+            }
+        }
+        else if constexpr (std::is_arithmetic_v<T>) {
+            T value;
+            if (numeric::parse(str, value)) {
+                return value;
+            }
+        }
+        else {
+            static_assert(not std::is_same_v<T, T>, "use a custom conversion for this type");
+        }
+        throw std::invalid_argument{"cannot convert '" + str + "'"};
+    }
+
+
+    template <typename T>
+    T Config::get() const {
+        T target{};
+        const auto assign{[this, &target](const auto& field) {
+            const auto& value{(*this)[field.key]};  // throws std::out_of_range
+            try {
+                target.*field.member = field.convert(value);
+            }
+            catch (const std::exception& ex) {
+                throw std::invalid_argument{"invalid value for '" + std::string{field.key} + "': " + ex.what()};
+            }
+        }};
+        std::apply([&assign](const auto&... fields) { (assign(fields), ...); }, Schema<T>::fields);
+        return target;
+    }
+
+
+    template <typename T>
+    void Config::bind(T& target) {
+        target = get<T>();
+        bindings.emplace_back([&target](const Config& config) { target = config.get<T>(); });
+        return;
+    }
 
 }  // namespace
 
@@ -30,9 +30,6 @@ using std::unique_ptr;
 using namespace Logging;
 
 
-Logger Logging::logger{"{{ cookiecutter.app_name }}"};
-
-
 string Logging::level(Level val) {
     // This does not handle NOTSET because it is a private implementation 
     // detail of this module.
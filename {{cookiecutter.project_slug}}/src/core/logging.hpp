@@ -287,8 +287,20 @@ namespace Logging {
         Level level;
         std::list<std::unique_ptr<const Handler>> handlers;
     };
-    
-    extern Logger logger;
+
+    /**
+     * Get the application logger.
+     *
+     * The logger is constructed on first use, so it is safe to use from
+     * static initializers in other translation units and from multiple
+     * threads. After that, each call is a single load and branch.
+     *
+     * @return logger
+     */
+    inline Logger& logger() {
+        static Logger instance{"{{ cookiecutter.app_name }}"};
+        return instance;
+    }
 }
 
 #endif  // {{ cookiecutter.app_name|upper }}_LOGGING_HPP
@@ -0,0 +1,88 @@
+/**
+ * Implementation of the memory module.
+ */
+#include "memory.hpp"
+#include <sys/resource.h>
+#include <algorithm>
+#include <fstream>
+#include <string>
+
+using namespace memory;
+
+
+namespace {  // internal linkage
+
+    bool hook_linked{false};  // constant-initialized before any allocation
+
+    thread_local Stats thread_stats;
+
+    /**
+     * Read a size from /proc/self/status.
+     *
+     * @param name field name, e.g. "VmRSS:"
+     * @return size in KiB, or 0 if it is not available
+     */
+    std::size_t status(const std::string& name) {
+        std::ifstream stream{"/proc/self/status"};
+        std::string field;
+        while (stream >> field) {
+            if (field == name) {
+                std::size_t size{0};
+                stream >> size;  // kB
+                return size;
+            }
+            stream.ignore(256, '\n');
+        }
+        return 0;
+    }
+}
+
+
+bool memory::tracking() noexcept {
+    return hook_linked;
+}
+
+
+Stats memory::stats() noexcept {
+    return thread_stats;
+}
+
+
+std::size_t memory::peak_rss() {
+    // The kernel updates ru_maxrss lazily, so use the larger of it and the
+    // high-water mark in /proc/self/status.
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+    const auto peak{static_cast<std::size_t>(usage.ru_maxrss) / 1024};  // bytes
+#else
+    const auto peak{static_cast<std::size_t>(usage.ru_maxrss)};
+#endif
+    return std::max(peak, status("VmHWM:"));
+}
+
+
+std::size_t memory::rss() {
+    return status("VmRSS:");
+}
+
+
+bool memory::detail::hook() noexcept {
+    hook_linked = true;
+    return hook_linked;
+}
+
+
+void memory::detail::allocated(std::size_t size) noexcept {
+    ++thread_stats.allocations;
+    thread_stats.bytes += size;
+    thread_stats.live += static_cast<std::int64_t>(size);
+    return;
+}
+
+
+void memory::detail::released(std::size_t size) noexcept {
+    ++thread_stats.deallocations;
+    thread_stats.live -= static_cast<std::int64_t>(size);
+    return;
+}
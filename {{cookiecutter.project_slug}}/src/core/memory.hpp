@@ -0,0 +1,130 @@
+/**
+ * Header for the memory module.
+ *
+ * Allocations are only counted if the global operator new/delete hook in
+ * core/new.cpp is linked into the program; see the TRACK_ALLOCATIONS CMake
+ * option. The unit tests always link the hook so that they can check
+ * allocation budgets.
+ *
+ * @file
+ */
+#ifndef {{ cookiecutter.app_name|upper }}_MEMORY_HPP
+#define {{ cookiecutter.app_name|upper }}_MEMORY_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace memory {
+    /**
+     * Heap usage counts for one thread.
+     *
+     * Memory freed by a different thread than the one that allocated it is
+     * subtracted from the freeing thread's live bytes, so live bytes can be
+     * negative. Byte counts are the usable size of each block, which may be
+     * larger than the requested size.
+     */
+    struct Stats {
+        std::uint64_t allocations{0};
+        std::uint64_t deallocations{0};
+        std::uint64_t bytes{0};  // total allocated
+        std::int64_t live{0};  // allocated - freed
+
+        /**
+         * Get the change since a previous value.
+         *
+         * @param start previous value
+         * @return difference
+         */
+        Stats operator-(const Stats& start) const noexcept {
+            return {
+                allocations - start.allocations,
+                deallocations - start.deallocations,
+                bytes - start.bytes,
+                live - start.live
+            };
+        }
+    };
+
+    /**
+     * Determine if allocations are being counted.
+     *
+     * @return true if the operator new/delete hook is linked
+     */
+    bool tracking() noexcept;
+
+    /**
+     * Get the heap usage for the current thread.
+     *
+     * @return counts since the thread started
+     */
+    Stats stats() noexcept;
+
+    /**
+     * Measure heap usage by the current thread over the lifetime of this
+     * object, e.g. to check the allocation budget of a function in a test.
+     */
+    class Usage {
+    public:
+        /**
+         * Start measuring.
+         */
+        Usage() noexcept :
+            start{stats()} {}
+
+        /**
+         * Get the heap usage since this object was created.
+         *
+         * @return counts
+         */
+        Stats get() const noexcept {
+            return stats() - start;
+        }
+
+    private:
+        const Stats start;
+    };
+
+    /**
+     * Get the peak resident set size of the process.
+     *
+     * This is read from getrusage() and, on Linux, /proc/self/status.
+     *
+     * @return size in KiB
+     */
+    std::size_t peak_rss();
+
+    /**
+     * Get the current resident set size of the process.
+     *
+     * This is read from /proc/self/status, so it is only available on Linux.
+     *
+     * @return size in KiB, or 0 if it is not available
+     */
+    std::size_t rss();
+
+    namespace detail {
+        /**
+         * Enable tracking; called by the operator new/delete hook.
+         *
+         * @return true
+         */
+        bool hook() noexcept;
+
+        /**
+         * Count an allocation for the current thread.
+         *
+         * @param size block size
+         */
+        void allocated(std::size_t size) noexcept;
+
+        /**
+         * Count a deallocation for the current thread.
+         *
+         * @param size block size
+         */
+        void released(std::size_t size) noexcept;
+    }
+}
+
+#endif  // {{ cookiecutter.app_name|upper }}_MEMORY_HPP
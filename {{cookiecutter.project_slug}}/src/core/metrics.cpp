@@ -0,0 +1,242 @@
+/**
+ * Implementation of the metrics module.
+ */
+#include "metrics.hpp"
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <system_error>
+
+using std::lock_guard;
+using std::mutex;
+using std::string;
+using std::uint64_t;
+
+using namespace metrics;
+
+
+namespace {  // internal linkage
+
+    /**
+     * Convert a metric name to a valid Prometheus name.
+     *
+     * @param name metric name
+     * @return Prometheus name
+     */
+    string sanitize(string name) {
+        for (auto& chr: name) {
+            if (not std::isalnum(static_cast<unsigned char>(chr)) and chr != '_' and chr != ':') {
+                chr = '_';
+            }
+        }
+        if (not name.empty() and std::isdigit(static_cast<unsigned char>(name.front()))) {
+            name.insert(name.begin(), '_');
+        }
+        return name;
+    }
+
+    /**
+     * Find or create a metric.
+     *
+     * @param metrics existing metrics
+     * @param name metric name
+     * @return metric
+     */
+    template <typename T>
+    T& find(std::map<string, std::unique_ptr<T>>& metrics, const string& name) {
+        auto& metric{metrics[name]};
+        if (not metric) {
+            metric = std::make_unique<T>();
+        }
+        return *metric;
+    }
+}
+
+
+size_t metrics::shard() noexcept {
+    static std::atomic<size_t> next{0};
+    thread_local const size_t index{next++ % shards};
+    return index;
+}
+
+
+uint64_t Counter::value() const noexcept {
+    uint64_t total{0};
+    for (const auto& cell: cells) {
+        total += cell.value.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+
+Histogram::Histogram() {
+    for (auto& cell: cells) {
+        cell = std::make_unique<Cell>();
+    }
+}
+
+
+Histogram::Snapshot Histogram::snapshot() const {
+    Snapshot snapshot;
+    snapshot.counts.resize(buckets);
+    for (const auto& cell: cells) {
+        for (size_t index{0}; index < buckets; ++index) {
+            const auto count{cell->counts[index].load(std::memory_order_relaxed)};
+            snapshot.counts[index] += count;
+            snapshot.count += count;
+        }
+        snapshot.sum += cell->sum.load(std::memory_order_relaxed);
+    }
+    return snapshot;
+}
+
+
+uint64_t Histogram::Snapshot::percentile(double percent) const noexcept {
+    if (count == 0) {
+        return 0;
+    }
+    // Find the bucket that contains the rank of the percentile.
+    const auto rank{std::max(static_cast<uint64_t>(percent / 100 * static_cast<double>(count) + 0.5), uint64_t{1})};
+    uint64_t total{0};
+    for (size_t index{0}; index < counts.size(); ++index) {
+        total += counts[index];
+        if (total >= rank) {
+            return upper(index);
+        }
+    }
+    return max();
+}
+
+
+uint64_t Histogram::Snapshot::max() const noexcept {
+    for (auto index{counts.size()}; index > 0; --index) {
+        if (counts[index - 1] > 0) {
+            return upper(index - 1);
+        }
+    }
+    return 0;
+}
+
+
+Counter& Registry::counter(const string& name) {
+    const lock_guard<mutex> lock{metrics_mutex};
+    return find(counters, name);
+}
+
+
+Gauge& Registry::gauge(const string& name) {
+    const lock_guard<mutex> lock{metrics_mutex};
+    return find(gauges, name);
+}
+
+
+Histogram& Registry::histogram(const string& name) {
+    const lock_guard<mutex> lock{metrics_mutex};
+    return find(histograms, name);
+}
+
+
+void Registry::dump(std::ostream& stream) const {
+    const lock_guard<mutex> lock{metrics_mutex};
+    for (const auto& [name, counter]: counters) {
+        stream << name << ' ' << counter->value() << '\n';
+    }
+    for (const auto& [name, gauge]: gauges) {
+        stream << name << ' ' << gauge->value() << '\n';
+    }
+    for (const auto& [name, histogram]: histograms) {
+        const auto data{histogram->snapshot()};
+        stream << name << " count=" << data.count;
+        if (data.count > 0) {
+            stream << " mean=" << data.sum / data.count
+                   << " p50=" << data.percentile(50)
+                   << " p90=" << data.percentile(90)
+                   << " p99=" << data.percentile(99)
+                   << " max=" << data.max();
+        }
+        stream << '\n';
+    }
+    stream.flush();
+    return;
+}
+
+
+void Registry::prometheus(std::ostream& stream) const {
+    const lock_guard<mutex> lock{metrics_mutex};
+    for (const auto& [name, counter]: counters) {
+        auto id{sanitize(name)};
+        if (id.size() < 6 or id.compare(id.size() - 6, 6, "_total") != 0) {
+            id += "_total";
+        }
+        stream << "# TYPE " << id << " counter\n" << id << ' ' << counter->value() << '\n';
+    }
+    for (const auto& [name, gauge]: gauges) {
+        const auto id{sanitize(name)};
+        stream << "# TYPE " << id << " gauge\n" << id << ' ' << gauge->value() << '\n';
+    }
+    for (const auto& [name, histogram]: histograms) {
+        // Every histogram is written with the same bucket bounds so that
+        // buckets can be aggregated across scrapes and processes. The bounds
+        // are 2^k - 1, which are also bucket bounds of Histogram, so the
+        // cumulative counts are exact. Values are integers, so "le" means
+        // less than 2^k.
+        const auto id{sanitize(name)};
+        const auto data{histogram->snapshot()};
+        stream << "# TYPE " << id << " histogram\n";
+        uint64_t total{0};
+        for (size_t index{0}; index < data.counts.size() - 1; ++index) {
+            total += data.counts[index];
+            const auto bound{Histogram::upper(index)};
+            if ((bound & (bound + 1)) == 0) {
+                stream << id << "_bucket{le=\"" << bound << "\"} " << total << '\n';
+            }
+        }
+        stream << id << "_bucket{le=\"+Inf\"} " << data.count << '\n';
+        stream << id << "_sum " << data.sum << '\n';
+        stream << id << "_count " << data.count << '\n';
+    }
+    stream.flush();
+    return;
+}
+
+
+Exporter::Exporter(const Registry& registry, std::filesystem::path path, std::chrono::milliseconds interval) :
+    registry{registry},
+    path{std::move(path)} {
+    thread = std::thread{[this, interval]() {
+        std::unique_lock<mutex> lock{sleep_mutex};
+        while (not wakeup.wait_for(lock, interval, [this]() { return stopping; })) {
+            write();
+        }
+    }};
+}
+
+
+Exporter::~Exporter() {
+    {
+        const lock_guard<mutex> lock{sleep_mutex};
+        stopping = true;
+    }
+    wakeup.notify_one();
+    thread.join();
+    write();
+    return;
+}
+
+
+void Exporter::write() const {
+    // Write to a temporary file and rename it so readers never see a partial
+    // file. Errors are ignored; the next write will try again.
+    auto temp{path};
+    temp += ".tmp";
+    {
+        std::ofstream stream{temp};
+        registry.prometheus(stream);
+        if (not stream) {
+            return;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temp, path, error);
+    return;
+}
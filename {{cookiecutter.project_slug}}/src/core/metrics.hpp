@@ -0,0 +1,357 @@
+/**
+ * Header for the metrics module.
+ *
+ * @file
+ */
+#ifndef {{ cookiecutter.app_name|upper }}_METRICS_HPP
+#define {{ cookiecutter.app_name|upper }}_METRICS_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace metrics {
+    /**
+     * Number of shards for each metric.
+     *
+     * Each thread updates one shard, so threads rarely contend for the same
+     * cache line. Shards are summed when a metric is read.
+     */
+    constexpr size_t shards{16};
+
+    /**
+     * Get the shard index for the current thread.
+     *
+     * @return shard index
+     */
+    size_t shard() noexcept;
+
+    /**
+     * Monotonic event counter.
+     */
+    class Counter {
+    public:
+        /**
+         * Increment the counter.
+         *
+         * @param count amount to add
+         */
+        void add(std::uint64_t count=1) noexcept {
+            cells[shard()].value.fetch_add(count, std::memory_order_relaxed);
+        }
+
+        /**
+         * Get the current value.
+         *
+         * @return sum of all shards
+         */
+        std::uint64_t value() const noexcept;
+
+    private:
+        struct alignas(64) Cell {
+            std::atomic<std::uint64_t> value{0};
+        };
+
+        std::array<Cell, shards> cells;
+    };
+
+    /**
+     * Instantaneous value, e.g. a queue length.
+     *
+     * The last value set by any thread wins, so a gauge is not sharded.
+     */
+    class Gauge {
+    public:
+        /**
+         * Set the value.
+         *
+         * @param value new value
+         */
+        void set(std::int64_t value) noexcept {
+            current.store(value, std::memory_order_relaxed);
+        }
+
+        /**
+         * Adjust the value.
+         *
+         * @param delta amount to add
+         */
+        void add(std::int64_t delta) noexcept {
+            current.fetch_add(delta, std::memory_order_relaxed);
+        }
+
+        /**
+         * Get the current value.
+         *
+         * @return value
+         */
+        std::int64_t value() const noexcept {
+            return current.load(std::memory_order_relaxed);
+        }
+
+    private:
+        std::atomic<std::int64_t> current{0};
+    };
+
+    /**
+     * Distribution of non-negative integer values, e.g. latency in ns.
+     *
+     * Values are counted in log-linear buckets as in an HDR histogram: each
+     * power of two is divided into 16 linear sub-buckets, so recorded values
+     * are accurate to within 1/16 (6.25%) over the entire 64-bit range.
+     */
+    class Histogram {
+    public:
+        static constexpr unsigned sub_bits{4};
+        static constexpr size_t buckets{(64 - sub_bits + 1) << sub_bits};
+
+        /**
+         * Aggregated histogram data.
+         */
+        struct Snapshot {
+            std::vector<std::uint64_t> counts;  // per bucket
+            std::uint64_t count{0};
+            std::uint64_t sum{0};
+
+            /**
+             * Estimate a percentile.
+             *
+             * @param percent percentile in the range [0, 100]
+             * @return upper bound of the bucket containing the percentile;
+             *   0 if the histogram is empty
+             */
+            std::uint64_t percentile(double percent) const noexcept;
+
+            /**
+             * Get the upper bound of the highest non-empty bucket.
+             *
+             * @return maximum value estimate
+             */
+            std::uint64_t max() const noexcept;
+        };
+
+        /**
+         * Get the bucket for a value.
+         *
+         * @param value value
+         * @return bucket index
+         */
+        static constexpr size_t bucket(std::uint64_t value) noexcept {
+            if (value < (1u << sub_bits)) {
+                return static_cast<size_t>(value);
+            }
+            unsigned magnitude{63};
+            while (not (value >> magnitude)) {
+                --magnitude;
+            }
+            const auto sub{(value >> (magnitude - sub_bits)) & ((1u << sub_bits) - 1)};
+            return ((magnitude - sub_bits + 1) << sub_bits) + static_cast<size_t>(sub);
+        }
+
+        /**
+         * Get the largest value in a bucket.
+         *
+         * @param index bucket index
+         * @return upper bound (inclusive)
+         */
+        static constexpr std::uint64_t upper(size_t index) noexcept {
+            if (index < (1u << sub_bits)) {
+                return index;
+            }
+            const auto magnitude{static_cast<unsigned>(index >> sub_bits) + sub_bits - 1};
+            const std::uint64_t sub{index & ((1u << sub_bits) - 1)};
+            const auto shift{magnitude - sub_bits};
+            const auto lower{((std::uint64_t{1} << sub_bits) | sub) << shift};
+            return lower + ((std::uint64_t{1} << shift) - 1);
+        }
+
+        /**
+         * Record a value.
+         *
+         * @param value value to record
+         */
+        void record(std::uint64_t value) noexcept {
+            auto& cell{*cells[shard() % cells.size()]};
+            cell.counts[bucket(value)].fetch_add(1, std::memory_order_relaxed);
+            cell.sum.fetch_add(value, std::memory_order_relaxed);
+        }
+
+        /**
+         * Construct an empty histogram.
+         */
+        Histogram();
+
+        /**
+         * Aggregate all shards.
+         *
+         * @return histogram data
+         */
+        Snapshot snapshot() const;
+
+    private:
+        struct alignas(64) Cell {
+            std::array<std::atomic<std::uint64_t>, buckets> counts{};
+            std::atomic<std::uint64_t> sum{0};
+        };
+
+        // Histograms are large, so use fewer shards than counters.
+        std::array<std::unique_ptr<Cell>, shards / 2> cells;
+    };
+
+    /**
+     * Record the lifetime of this object in a histogram.
+     */
+    class Timer {
+    public:
+        /**
+         * Start the timer.
+         *
+         * @param histogram histogram for elapsed time in nanoseconds
+         */
+        explicit Timer(Histogram& histogram) noexcept :
+            histogram{histogram},
+            start{std::chrono::steady_clock::now()} {}
+
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+
+        /**
+         * Record the elapsed time.
+         */
+        ~Timer() {
+            const auto elapsed{std::chrono::steady_clock::now() - start};
+            histogram.record(static_cast<std::uint64_t>(std::chrono::nanoseconds(elapsed).count()));
+        }
+
+    private:
+        Histogram& histogram;
+        const std::chrono::steady_clock::time_point start;
+    };
+
+    /**
+     * Collection of named metrics.
+     *
+     * Metrics are created on first use and live as long as the registry, so
+     * clients can keep references to them. Lookups take a lock, but updates
+     * are lock-free, so look up a metric once in hot code.
+     */
+    class Registry {
+    public:
+        /**
+         * Get a counter.
+         *
+         * @param name metric name, e.g. "command.cmd1.calls"
+         * @return counter
+         */
+        Counter& counter(const std::string& name);
+
+        /**
+         * Get a gauge.
+         *
+         * @param name metric name
+         * @return gauge
+         */
+        Gauge& gauge(const std::string& name);
+
+        /**
+         * Get a histogram.
+         *
+         * @param name metric name
+         * @return histogram
+         */
+        Histogram& histogram(const std::string& name);
+
+        /**
+         * Write all metrics in a human-readable format.
+         *
+         * Histograms are summarized by count, mean, and percentiles.
+         *
+         * @param stream output stream
+         */
+        void dump(std::ostream& stream) const;
+
+        /**
+         * Write all metrics in the Prometheus text format.
+         *
+         * Characters that are not valid in a Prometheus metric name are
+         * replaced by '_', and counter names end with "_total". Histogram
+         * buckets have fixed bounds at 2^k - 1, so every histogram has the
+         * same `le` labels whether or not its buckets are empty.
+         *
+         * @param stream output stream
+         */
+        void prometheus(std::ostream& stream) const;
+
+    private:
+        mutable std::mutex metrics_mutex;
+        std::map<std::string, std::unique_ptr<Counter>> counters;
+        std::map<std::string, std::unique_ptr<Gauge>> gauges;
+        std::map<std::string, std::unique_ptr<Histogram>> histograms;
+    };
+
+    /**
+     * Periodically write metrics to a Prometheus text file.
+     *
+     * The file is replaced atomically, so it can be read at any time, e.g. by
+     * the node_exporter textfile collector.
+     */
+    class Exporter {
+    public:
+        /**
+         * Start writing metrics.
+         *
+         * @param registry metrics to write
+         * @param path output file path
+         * @param interval time between writes
+         */
+        Exporter(const Registry& registry, std::filesystem::path path, std::chrono::milliseconds interval);
+
+        Exporter(const Exporter&) = delete;
+        Exporter& operator=(const Exporter&) = delete;
+
+        /**
+         * Stop writing metrics after one final write.
+         */
+        ~Exporter();
+
+    private:
+        const Registry& registry;
+        const std::filesystem::path path;
+        std::mutex sleep_mutex;
+        std::condition_variable wakeup;
+        bool stopping{false};
+        std::thread thread;
+
+        /**
+         * Write the metrics file.
+         */
+        void write() const;
+    };
+
+    /**
+     * Get the application metrics registry.
+     *
+     * The registry is constructed on first use, so it is safe to use from
+     * static initializers in other translation units and from multiple
+     * threads.
+     *
+     * @return registry
+     */
+    inline Registry& registry() {
+        static Registry instance;
+        return instance;
+    }
+}
+
+#endif  // {{ cookiecutter.app_name|upper }}_METRICS_HPP
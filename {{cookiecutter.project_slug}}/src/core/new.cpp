@@ -0,0 +1,173 @@
+/**
+ * Replacement global operator new/delete that count allocations.
+ *
+ * Link this file into a program to enable memory::stats(). Blocks are
+ * allocated with malloc(), and their usable size is counted so that the
+ * unsized and sized forms of delete agree.
+ */
+#include "memory.hpp"
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#if defined(__APPLE__)
+#include <malloc/malloc.h>
+#else
+#include <malloc.h>
+#endif
+
+
+namespace {  // internal linkage
+
+    const bool hooked{memory::detail::hook()};
+
+    /**
+     * Get the usable size of a block.
+     *
+     * @param ptr block from malloc()
+     * @return size in bytes
+     */
+    std::size_t usable(void* ptr) noexcept {
+#if defined(__APPLE__)
+        return malloc_size(ptr);
+#else
+        return malloc_usable_size(ptr);
+#endif
+    }
+
+    /**
+     * Allocate a block, calling the new handler on failure.
+     *
+     * @param size requested size
+     * @param align requested alignment
+     * @return block, or nullptr if there is no new handler
+     */
+    void* allocate(std::size_t size, std::size_t align) noexcept {
+        for (;;) {
+            void* ptr{nullptr};
+            if (align <= alignof(std::max_align_t)) {
+                ptr = std::malloc(size > 0 ? size : 1);
+            }
+            else if (posix_memalign(&ptr, align, size > 0 ? size : 1) != 0) {
+                ptr = nullptr;
+            }
+            if (ptr) {
+                memory::detail::allocated(usable(ptr));
+                return ptr;
+            }
+            const auto handler{std::get_new_handler()};
+            if (not handler) {
+                return nullptr;
+            }
+            handler();  // may throw
+        }
+    }
+
+    /**
+     * Free a block.
+     *
+     * @param ptr block from allocate()
+     */
+    void release(void* ptr) noexcept {
+        if (ptr) {
+            memory::detail::released(usable(ptr));
+            std::free(ptr);
+        }
+        return;
+    }
+
+    /**
+     * Allocate a block or throw std::bad_alloc.
+     *
+     * @param size requested size
+     * @param align requested alignment
+     * @return block
+     */
+    void* allocate_or_throw(std::size_t size, std::size_t align) {
+        const auto ptr{allocate(size, align)};
+        if (not ptr) {
+            throw std::bad_alloc{};
+        }
+        return ptr;
+    }
+}
+
+
+void* operator new(std::size_t size) {
+    return allocate_or_throw(size, alignof(std::max_align_t));
+}
+
+void* operator new[](std::size_t size) {
+    return allocate_or_throw(size, alignof(std::max_align_t));
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size, alignof(std::max_align_t));
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size, alignof(std::max_align_t));
+}
+
+void* operator new(std::size_t size, std::align_val_t align) {
+    return allocate_or_throw(size, static_cast<std::size_t>(align));
+}
+
+void* operator new[](std::size_t size, std::align_val_t align) {
+    return allocate_or_throw(size, static_cast<std::size_t>(align));
+}
+
+void* operator new(std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    return allocate(size, static_cast<std::size_t>(align));
+}
+
+void* operator new[](std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    return allocate(size, static_cast<std::size_t>(align));
+}
+
+void operator delete(void* ptr) noexcept {
+    release(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    release(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    release(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+    release(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+    release(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+    release(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+    release(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept {
+    release(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept {
+    release(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept {
+    release(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept {
+    release(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept {
+    release(ptr);
+}
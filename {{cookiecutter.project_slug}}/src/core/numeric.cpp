@@ -0,0 +1,52 @@
+/**
+ * Implementation of the numeric module.
+ */
+#include "numeric.hpp"
+#if not defined(__cpp_lib_to_chars)
+#include <locale>
+#include <sstream>
+#include <string>
+#endif
+
+
+namespace {  // internal linkage
+
+    /**
+     * Parse a floating point number.
+     *
+     * @tparam T floating point type
+     * @param str string to parse
+     * @param value parsed value
+     * @return true on success
+     */
+    template <typename T>
+    bool parse_real(std::string_view str, T& value) {
+#if defined(__cpp_lib_to_chars)
+        const auto last{str.data() + str.size()};
+        const auto [ptr, err]{std::from_chars(str.data(), last, value)};
+        return err == std::errc{} and ptr == last;
+#else
+        if (str.empty() or str.front() == '+' or std::isspace(str.front(), std::locale::classic())) {
+            return false;  // accepted by streams but not by std::from_chars()
+        }
+        std::istringstream stream{std::string{str}};
+        stream.imbue(std::locale::classic());
+        return stream >> value and stream.peek() == std::istringstream::traits_type::eof();
+#endif
+    }
+}
+
+
+bool numeric::parse(std::string_view str, float& value) {
+    return parse_real(str, value);
+}
+
+
+bool numeric::parse(std::string_view str, double& value) {
+    return parse_real(str, value);
+}
+
+
+bool numeric::parse(std::string_view str, long double& value) {
+    return parse_real(str, value);
+}
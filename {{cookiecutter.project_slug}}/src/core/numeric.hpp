@@ -0,0 +1,57 @@
+/**
+ * Header for the numeric module.
+ *
+ * Strict number parsing shared by the command line and config modules.
+ *
+ * @file
+ */
+#ifndef {{ cookiecutter.app_name|upper }}_NUMERIC_HPP
+#define {{ cookiecutter.app_name|upper }}_NUMERIC_HPP
+
+#include <charconv>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+
+namespace numeric {
+    /**
+     * Parse an integer.
+     *
+     * The whole string must be a decimal integer in the range of the value
+     * type. Leading whitespace and a leading '+' are not allowed.
+     *
+     * @tparam T integer type
+     * @param str string to parse
+     * @param value parsed value; this is unspecified on failure
+     * @return true on success
+     */
+    template <typename T>
+    bool parse(std::string_view str, T& value) noexcept {
+        static_assert(std::is_integral_v<T> and not std::is_same_v<T, bool>, "unsupported value type");
+        const auto last{str.data() + str.size()};
+        const auto [ptr, err]{std::from_chars(str.data(), last, value)};
+        return err == std::errc{} and ptr == last;
+    }
+
+    /**
+     * Parse a floating point number.
+     *
+     * The rules are the same as for integers. Not all standard libraries
+     * support std::from_chars() for floating point values, so this uses a
+     * stream with the classic locale for libraries that do not.
+     *
+     * @param str string to parse
+     * @param value parsed value; this is unspecified on failure
+     * @return true on success
+     */
+    bool parse(std::string_view str, float& value);
+
+    /** @overload */
+    bool parse(std::string_view str, double& value);
+
+    /** @overload */
+    bool parse(std::string_view str, long double& value);
+}
+
+#endif  // {{ cookiecutter.app_name|upper }}_NUMERIC_HPP
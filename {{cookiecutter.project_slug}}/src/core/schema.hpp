@@ -0,0 +1,487 @@
+/**
+ * Compile-time command line schemas.
+ *
+ * This module is an alternative to CommandLine for applications with a fixed
+ * command line grammar. The grammar is declared as a `constexpr` schema that
+ * binds each option, positional argument, and subcommand to a member of a
+ * results struct:
+ *
+ *     struct Args {
+ *         bool verbose;
+ *         int jobs{1};
+ *         std::vector<std::string_view> files;
+ *     };
+ *
+ *     constexpr auto args_schema{schema::command<Args>(
+ *         schema::opt("verbose", 'v', &Args::verbose),
+ *         schema::opt("jobs", 'j', &Args::jobs),
+ *         schema::pos("files", &Args::files)
+ *     )};
+ *
+ *     const auto args{args_schema.parse(argc, argv)};
+ *
+ * The parser for each schema is generated by the compiler, and the schema
+ * itself does not use any dynamic containers. Duplicate names or flags are a
+ * compile error for a `constexpr` schema (or a `std::logic_error` exception
+ * for a schema that is created at runtime).
+ *
+ * The command line syntax is the same as for CommandLine with strict argument
+ * checking. A `bool` member is an option without a value, and a
+ * `std::vector` member collects multiple values. Values are converted when
+ * they are parsed, and any error causes a `std::runtime_error` exception.
+ * String view members refer directly to `argv`.
+ *
+ * This is a standalone alternative to CommandLine; the application itself does
+ * not use it. The application CLI still uses CommandLine because each entry in
+ * the subcommand table in cli.cpp defines its own arguments, and subcommand
+ * handlers receive a CommandLine.
+ *
+ * @file
+ */
+#ifndef {{ cookiecutter.app_name|upper }}_SCHEMA_HPP
+#define {{ cookiecutter.app_name|upper }}_SCHEMA_HPP
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+#include "numeric.hpp"
+
+
+namespace schema {
+    /**
+     * Schema element types.
+     */
+    enum class Kind { opt, pos, sub };
+
+    /**
+     * Indicate that an option only has a long name.
+     */
+    constexpr char noflag{'\0'};
+
+    /**
+     * Determine if a type is a std::vector.
+     */
+    template <typename M>
+    struct is_vector: std::false_type {};
+
+    template <typename V>
+    struct is_vector<std::vector<V>>: std::true_type {};
+
+    /**
+     * Option definition; use opt() to create.
+     *
+     * @tparam T results struct type
+     * @tparam M member type
+     */
+    template <typename T, typename M>
+    struct Opt {
+        static constexpr Kind kind{Kind::opt};
+        static constexpr bool has_val{not std::is_same_v<M, bool>};
+        std::string_view name;
+        char flag;
+        M T::* member;
+    };
+
+    /**
+     * Positional argument definition; use pos() to create.
+     *
+     * @tparam T results struct type
+     * @tparam M member type
+     */
+    template <typename T, typename M>
+    struct Pos {
+        static constexpr Kind kind{Kind::pos};
+        std::string_view name;
+        std::size_t count;  // 0 for all remaining arguments
+        M T::* member;
+    };
+
+    /**
+     * Subcommand definition; use sub() to create.
+     *
+     * @tparam T results struct type
+     * @tparam S subcommand results struct type
+     * @tparam C subcommand schema type
+     */
+    template <typename T, typename S, typename C>
+    struct Sub {
+        static constexpr Kind kind{Kind::sub};
+        std::string_view name;
+        std::optional<S> T::* member;
+        C command;
+    };
+
+    /**
+     * Define an option with a long name and a flag.
+     *
+     * @param name long name
+     * @param flag flag character
+     * @param member results struct member
+     * @return option definition
+     */
+    template <typename T, typename M>
+    constexpr Opt<T, M> opt(std::string_view name, char flag, M T::* member) {
+        return {name, flag, member};
+    }
+
+    /**
+     * Define an option with only a long name.
+     *
+     * @param name long name
+     * @param member results struct member
+     * @return option definition
+     */
+    template <typename T, typename M>
+    constexpr Opt<T, M> opt(std::string_view name, M T::* member) {
+        return {name, noflag, member};
+    }
+
+    /**
+     * Define a positional argument.
+     *
+     * A vector member collects all remaining arguments by default, otherwise
+     * exactly one argument is expected.
+     *
+     * @param name argument name
+     * @param member results struct member
+     * @param count number of arguments for a vector member
+     * @return argument definition
+     */
+    template <typename T, typename M>
+    constexpr Pos<T, M> pos(std::string_view name, M T::* member, std::size_t count=0) {
+        return {name, is_vector<M>::value ? count : 1, member};
+    }
+
+    /**
+     * Define a subcommand.
+     *
+     * If the subcommand is parsed, its results are stored in an optional
+     * member of the parent results struct.
+     *
+     * @param name subcommand name
+     * @param member results struct member
+     * @param command subcommand schema
+     * @return subcommand definition
+     */
+    template <typename T, typename S, typename C>
+    constexpr Sub<T, S, C> sub(std::string_view name, std::optional<S> T::* member, C command) {
+        return {name, member, command};
+    }
+
+    /**
+     * Convert an argument to a value.
+     *
+     * @tparam V value type
+     * @param name argument name for error messages
+     * @param str argument string
+     * @return converted value
+     */
+    template <typename V>
+    V convert(std::string_view name, std::string_view str) {
+        if constexpr (std::is_same_v<V, std::string_view>) {
+            return str;
+        }
+        else if constexpr (std::is_same_v<V, std::string>) {
+            return std::string(str);
+        }
+        else {
+            static_assert(std::is_arithmetic_v<V>, "unsupported value type");
+            V val{};
+            if (not numeric::parse(str, val)) {
+                throw std::runtime_error("invalid value for " + std::string(name) + ": " + std::string(str));
+            }
+            return val;
+        }
+    }
+
+    /**
+     * Command line schema.
+     *
+     * Use command() to create a schema.
+     *
+     * @tparam T results struct type
+     * @tparam Defs element definition types
+     */
+    template <typename T, typename... Defs>
+    class Command {
+    public:
+        typedef char* const* ArgvIter;
+
+        /**
+         * Construct a schema.
+         *
+         * @param defs option, positional argument, and subcommand definitions
+         */
+        constexpr explicit Command(Defs... defs) :
+            defs{defs...} {
+            check();
+        }
+
+        /**
+         * Parse command-line arguments.
+         *
+         * The arguments are as passed to main(), and the first argument is
+         * the command name. A `std::runtime_error` exception is thrown for
+         * invalid arguments.
+         *
+         * @param argc argument count
+         * @param argv argument values
+         * @return parsed results
+         */
+        T parse(int argc, char* argv[]) const {
+            T args{};
+            ArgvIter iter(argv + (argc > 0 ? 1 : 0));
+            parse(iter, argv + argc, args);
+            return args;
+        }
+
+        /**
+         * Parse arguments following the command name.
+         *
+         * @param iter current argv position
+         * @param end end of argv
+         * @param args results struct
+         */
+        void parse(ArgvIter& iter, ArgvIter end, T& args) const {
+            while (iter != end) {
+                // Options must come before positional arguments.
+                const std::string_view arg(*iter);
+                if (arg.size() < 2 or arg[0] != '-') {
+                    break;
+                }
+                ++iter;
+                if (arg.find_first_not_of('-') == std::string_view::npos) {
+                    break;  // `--` ends option processing
+                }
+                const bool is_long(arg[1] == '-');
+                std::string_view key(arg.substr(is_long ? 2 : 1));
+                std::optional<std::string_view> val;
+                if (is_long) {
+                    const auto pos(key.find('='));
+                    if (pos != std::string_view::npos) {
+                        val = key.substr(pos + 1);
+                        key = key.substr(0, pos);
+                    }
+                }
+                else if (key.size() > 1) {
+                    val = key.substr(1);
+                    key = key.substr(0, 1);
+                }
+                const auto match([&](const auto&... def) {
+                    return (parse_opt(def, key, is_long, val, iter, end, args) or ...);
+                });
+                if (not std::apply(match, defs)) {
+                    throw std::runtime_error("unknown option: " + std::string(arg));
+                }
+            }
+            if (iter != end) {
+                const std::string_view name(*iter);
+                const auto match([&](const auto&... def) {
+                    return (parse_sub(def, name, iter, end, args) or ...);
+                });
+                if (std::apply(match, defs)) {
+                    return;  // subcommand parsed all remaining arguments
+                }
+            }
+            std::apply([&](const auto&... def) { (parse_pos(def, iter, end, args), ...); }, defs);
+            if (iter != end) {
+                throw std::runtime_error("unexpected positional arguments");
+            }
+            return;
+        }
+
+        /**
+         * Generate a usage message.
+         *
+         * @param name command name
+         * @return the formatted usage message
+         */
+        std::string usage(std::string_view name) const {
+            std::string text{"usage: "};
+            text += name;
+            std::string subs;
+            const auto append([&text, &subs](const auto& def) {
+                typedef std::decay_t<decltype(def)> Def;
+                if constexpr (Def::kind == Kind::opt) {
+                    text += " [";
+                    if (def.flag != noflag) {
+                        text += '-';
+                        text += def.flag;
+                        text += '|';
+                    }
+                    text += "--";
+                    text += def.name;
+                    if constexpr (Def::has_val) {
+                        text += " VALUE";
+                    }
+                    text += "]";
+                }
+                else if constexpr (Def::kind == Kind::pos) {
+                    text += ' ';
+                    text += def.name;
+                    if (def.count != 1) {
+                        text += "...";
+                    }
+                }
+                else {
+                    subs += subs.empty() ? "" : "|";
+                    subs += def.name;
+                }
+            });
+            std::apply([&append](const auto&... def) { (append(def), ...); }, defs);
+            if (not subs.empty()) {
+                text += " [" + subs + "] ...";
+            }
+            return text;
+        }
+
+    private:
+        std::tuple<Defs...> defs;
+
+        /**
+         * Verify that names and flags are unique.
+         *
+         * This throws a `std::logic_error` exception, which is a compile
+         * error when evaluated in a constant expression.
+         */
+        constexpr void check() const {
+            constexpr std::size_t size{sizeof...(Defs)};
+            std::array<std::string_view, size> names{};
+            std::array<char, size> flags{};
+            std::size_t count{0};
+            bool rest{false};  // positional argument takes remaining args
+            const auto collect([&](const auto& def) {
+                typedef std::decay_t<decltype(def)> Def;
+                if constexpr (Def::kind == Kind::opt) {
+                    flags[count] = def.flag;
+                }
+                if constexpr (Def::kind == Kind::pos) {
+                    if (rest) {
+                        throw std::logic_error("positional argument follows variable arguments");
+                    }
+                    rest = def.count == 0;
+                }
+                names[count++] = def.name;
+            });
+            std::apply([&collect](const auto&... def) { (collect(def), ...); }, defs);
+            for (std::size_t pos{0}; pos < size; ++pos) {
+                for (std::size_t next{pos + 1}; next < size; ++next) {
+                    if (names[pos] == names[next]) {
+                        throw std::logic_error("duplicate name in command schema");
+                    }
+                    if (flags[pos] != noflag and flags[pos] == flags[next]) {
+                        throw std::logic_error("duplicate flag in command schema");
+                    }
+                }
+            }
+        }
+
+        /**
+         * Parse an option if it matches a definition.
+         *
+         * @return true if the option matched
+         */
+        template <typename Def>
+        static bool parse_opt(const Def& def, std::string_view key, bool is_long, std::optional<std::string_view> val, ArgvIter& iter, ArgvIter end, T& args) {
+            if constexpr (Def::kind != Kind::opt) {
+                return false;
+            }
+            else {
+                if (is_long ? key != def.name : (def.flag == noflag or key[0] != def.flag)) {
+                    return false;
+                }
+                if constexpr (not Def::has_val) {
+                    if (val) {
+                        throw std::runtime_error("unexpected value for option " + std::string(def.name));
+                    }
+                    args.*def.member = true;
+                }
+                else {
+                    if (not val) {
+                        // Next argument should be the option value.
+                        if (iter == end) {
+                            throw std::runtime_error("missing value for option " + std::string(def.name));
+                        }
+                        val = *iter++;
+                    }
+                    assign(def.name, *val, args.*def.member);
+                }
+                return true;
+            }
+        }
+
+        /**
+         * Parse a subcommand if it matches a definition.
+         *
+         * @return true if the subcommand matched
+         */
+        template <typename Def>
+        static bool parse_sub(const Def& def, std::string_view name, ArgvIter& iter, ArgvIter end, T& args) {
+            if constexpr (Def::kind != Kind::sub) {
+                return false;
+            }
+            else {
+                if (name != def.name) {
+                    return false;
+                }
+                ++iter;
+                def.command.parse(iter, end, (args.*def.member).emplace());
+                return true;
+            }
+        }
+
+        /**
+         * Parse positional arguments for a definition.
+         */
+        template <typename Def>
+        static void parse_pos(const Def& def, ArgvIter& iter, ArgvIter end, T& args) {
+            if constexpr (Def::kind == Kind::pos) {
+                const auto available(static_cast<std::size_t>(end - iter));
+                if (def.count > available) {
+                    throw std::runtime_error("missing argument(s): " + std::string(def.name));
+                }
+                const auto last(def.count == 0 ? end : iter + def.count);
+                for (; iter != last; ++iter) {
+                    assign(def.name, *iter, args.*def.member);
+                }
+            }
+            return;
+        }
+
+        /**
+         * Assign an argument to a member.
+         */
+        template <typename M>
+        static void assign(std::string_view name, std::string_view str, M& member) {
+            if constexpr (is_vector<M>::value) {
+                member.push_back(convert<typename M::value_type>(name, str));
+            }
+            else {
+                member = convert<M>(name, str);
+            }
+            return;
+        }
+    };
+
+    /**
+     * Create a command line schema.
+     *
+     * Declare the result `constexpr` to check the schema at compile time.
+     *
+     * @tparam T results struct type
+     * @param defs option, positional argument, and subcommand definitions
+     * @return new schema
+     */
+    template <typename T, typename... Defs>
+    constexpr Command<T, Defs...> command(Defs... defs) {
+        return Command<T, Defs...>{defs...};
+    }
+}  // namespace
+
+#endif  // {{ cookiecutter.app_name|upper }}_SCHEMA_HPP
@@ -0,0 +1,155 @@
+/**
+ * Implementation of the trace module.
+ */
+#include "trace.hpp"
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <vector>
+
+using std::int64_t;
+using std::mutex;
+using std::lock_guard;
+
+
+namespace {  // internal linkage
+
+    /**
+     * Span buffer for one thread.
+     *
+     * Buffers are owned by the global list so that spans from threads that
+     * have exited are still written.
+     */
+    struct Buffer {
+        unsigned tid;
+        std::vector<trace::Event> events;
+    };
+
+#if defined(__GNUC__)
+    // Construct this before other static objects to include their startup
+    // cost in the trace.
+    const std::chrono::steady_clock::time_point epoch __attribute__((init_priority(101))) {
+        std::chrono::steady_clock::now()
+    };
+#else
+    const std::chrono::steady_clock::time_point epoch{std::chrono::steady_clock::now()};
+#endif
+    mutex buffers_mutex;  // guards buffers, not their contents
+    std::vector<std::unique_ptr<Buffer>> buffers;
+
+    /**
+     * Get the buffer for the current thread.
+     *
+     * @return buffer
+     */
+    Buffer& local() {
+        thread_local Buffer* buffer{nullptr};
+        if (not buffer) {
+            const lock_guard<mutex> lock{buffers_mutex};
+            buffers.push_back(std::make_unique<Buffer>());
+            buffer = buffers.back().get();
+            buffer->tid = static_cast<unsigned>(buffers.size());
+            buffer->events.reserve(1024);
+        }
+        return *buffer;
+    }
+
+    /**
+     * Write a JSON string.
+     *
+     * @param stream output stream
+     * @param str string to write
+     */
+    void quote(std::ostream& stream, const char* str) {
+        stream << '"';
+        for (; *str; ++str) {
+            if (*str == '"' or *str == '\\') {
+                stream << '\\';
+            }
+            stream << *str;
+        }
+        stream << '"';
+        return;
+    }
+}
+
+
+std::atomic<bool> trace::active{false};
+
+
+int64_t trace::now() noexcept {
+    const auto elapsed{std::chrono::steady_clock::now() - epoch};
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+}
+
+
+void trace::record(const char* name, int64_t start, int64_t end) {
+    local().events.push_back({name, start, end});
+    return;
+}
+
+
+void trace::start() {
+    {
+        const lock_guard<mutex> lock{buffers_mutex};
+        for (auto& buffer: buffers) {
+            buffer->events.clear();
+        }
+    }
+    active = true;
+    return;
+}
+
+
+void trace::stop() noexcept {
+    active = false;
+    return;
+}
+
+
+void trace::write(std::ostream& stream) {
+    // Times are in microseconds. Complete ("X") events are used so that each
+    // span is a single record.
+    const lock_guard<mutex> lock{buffers_mutex};
+    const auto pid{getpid()};
+    const char* separator{"\n"};
+    stream << "{\"traceEvents\": [";
+    for (const auto& buffer: buffers) {
+        for (const auto& event: buffer->events) {
+            stream << separator << "{\"name\": ";
+            quote(stream, event.name);
+            stream << ", \"ph\": \"X\", \"pid\": " << pid << ", \"tid\": " << buffer->tid
+                   << ", \"ts\": " << event.start / 1000 << '.' << event.start % 1000 / 100
+                   << ", \"dur\": " << (event.end - event.start) / 1000 << '.' << (event.end - event.start) % 1000 / 100
+                   << "}";
+            separator = ",\n";
+        }
+    }
+    stream << "\n], \"displayTimeUnit\": \"ms\"}\n";
+    stream.flush();
+    return;
+}
+
+
+void trace::write(const std::filesystem::path& path) {
+    std::ofstream stream{path};
+    if (not stream) {
+        throw std::system_error{errno, std::generic_category(), "cannot write " + path.string()};
+    }
+    write(stream);
+    return;
+}
+
+
+std::vector<trace::Event> trace::events() {
+    auto events{local().events};
+    std::stable_sort(events.begin(), events.end(), [](const Event& lhs, const Event& rhs) {
+        return lhs.start < rhs.start;
+    });
+    return events;
+}
@@ -0,0 +1,148 @@
+/**
+ * Header for the trace module.
+ *
+ * Spans are recorded with the TRACE_SCOPE macro and written in the Chrome
+ * trace-event format, which can be viewed with Perfetto or chrome://tracing.
+ *
+ * @file
+ */
+#ifndef {{ cookiecutter.app_name|upper }}_TRACE_HPP
+#define {{ cookiecutter.app_name|upper }}_TRACE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <ostream>
+#include <vector>
+
+
+namespace trace {
+    /**
+     * Global tracing switch; use enabled() to read it.
+     */
+    extern std::atomic<bool> active;
+
+    /**
+     * Determine if tracing is enabled.
+     *
+     * @return true if spans are being recorded
+     */
+    inline bool enabled() noexcept {
+        return active.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * A completed span.
+     */
+    struct Event {
+        const char* name;
+        std::int64_t start;
+        std::int64_t end;
+    };
+
+    /**
+     * Get the current trace time.
+     *
+     * The trace clock starts during static initialization, before any other
+     * static objects are constructed if the compiler supports it, so times
+     * include program startup.
+     *
+     * @return nanoseconds since the program started
+     */
+    std::int64_t now() noexcept;
+
+    /**
+     * Record a completed span for the current thread.
+     *
+     * Each thread appends to its own buffer, so this does not lock after the
+     * first span on a thread.
+     *
+     * @param name span name; must have static storage duration
+     * @param start start time from now()
+     * @param end end time from now()
+     */
+    void record(const char* name, std::int64_t start, std::int64_t end);
+
+    /**
+     * Start recording spans.
+     *
+     * Any previously recorded spans are discarded. This must not be called
+     * while other threads are recording spans.
+     */
+    void start();
+
+    /**
+     * Stop recording spans.
+     */
+    void stop() noexcept;
+
+    /**
+     * Write all recorded spans as a Chrome trace-event JSON document.
+     *
+     * This must not be called while other threads are recording spans.
+     *
+     * @param stream output stream
+     */
+    void write(std::ostream& stream);
+
+    /** @overload */
+    void write(const std::filesystem::path& path);
+
+    /**
+     * Get the spans recorded by the current thread.
+     *
+     * @return spans in order of start time
+     */
+    std::vector<Event> events();
+
+    /**
+     * Record the lifetime of this object as a span.
+     *
+     * If tracing is disabled when the span is created, it does nothing else.
+     */
+    class Span {
+    public:
+        /**
+         * Start a span.
+         *
+         * @param name span name; must have static storage duration, e.g. a
+         *   string literal
+         */
+        explicit Span(const char* name) noexcept :
+            name{enabled() ? name : nullptr},
+            start{this->name ? now() : 0} {}
+
+        Span(const Span&) = delete;
+        Span& operator=(const Span&) = delete;
+
+        /**
+         * End the span.
+         */
+        ~Span() {
+            if (name) {
+                record(name, start, now());
+            }
+        }
+
+    private:
+        const char* const name;
+        const std::int64_t start;
+    };
+}
+
+
+#define TRACE_CONCAT_(lhs, rhs) lhs##rhs
+#define TRACE_CONCAT(lhs, rhs) TRACE_CONCAT_(lhs, rhs)
+
+/**
+ * Trace the enclosing scope, e.g. `TRACE_SCOPE("config.load")`.
+ *
+ * Define NO_TRACING to compile spans out entirely.
+ */
+#if defined(NO_TRACING)
+#define TRACE_SCOPE(name) static_cast<void>(0)
+#else
+#define TRACE_SCOPE(name) const trace::Span TRACE_CONCAT(trace_span_, __LINE__){name}
+#endif
+
+#endif  // {{ cookiecutter.app_name|upper }}_TRACE_HPP
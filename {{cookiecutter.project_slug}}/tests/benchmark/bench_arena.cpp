@@ -0,0 +1,53 @@
+/**
+ * Benchmarks for the Arena class.
+ *
+ * Compare the allocation throughput of a per-command arena with the default
+ * global allocator for many small, short-lived strings.
+ */
+#include <benchmark/benchmark.h>
+#include <memory_resource>
+#include <string>
+#include <vector>
+#include "core/Arena.hpp"
+
+namespace {
+
+    constexpr size_t count{1000};  // strings per simulated command
+    const std::string text{"a string that is too long for the small string optimization"};
+}
+
+
+/**
+ * Allocate strings using the global allocator.
+ */
+static void BM_new(benchmark::State& state) {
+    for (auto _: state) {
+        std::vector<std::string> strings;
+        for (size_t pos{0}; pos < count; ++pos) {
+            strings.emplace_back(text);
+        }
+        benchmark::DoNotOptimize(strings.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+    return;
+}
+BENCHMARK(BM_new);
+
+
+/**
+ * Allocate strings from an arena that is reset after each command.
+ */
+static void BM_arena(benchmark::State& state) {
+    Arena arena;
+    for (auto _: state) {
+        const Arena::Scope scope{arena};
+        std::pmr::vector<std::pmr::string> strings{Arena::current()};
+        for (size_t pos{0}; pos < count; ++pos) {
+            strings.emplace_back(text);
+        }
+        benchmark::DoNotOptimize(strings.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+    return;
+}
+BENCHMARK(BM_arena);
@@ -0,0 +1,84 @@
+/**
+ * Benchmarks for the ChunkReader class.
+ *
+ * Measure the throughput of counting lines in a large file with a single
+ * stream and with parallel chunks. Throughput is reported as bytes/second.
+ */
+#include <benchmark/benchmark.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <string_view>
+#include "core/ChunkReader.hpp"
+
+namespace {
+
+    std::string path;  // unique for each run
+    constexpr size_t file_size{256 * 1024 * 1024};
+
+    /**
+     * Create the input file.
+     */
+    void setup(const benchmark::State&) {
+        char temp[]{"/tmp/bench_chunks.XXXXXX"};
+        const auto fd{mkstemp(temp)};
+        if (fd != -1) {
+            close(fd);
+        }
+        path = temp;
+        std::ofstream file{path};
+        const std::string line{"the quick brown fox jumps over the lazy dog 0123456789\n"};
+        for (size_t size{0}; size < file_size; size += line.size()) {
+            file << line;
+        }
+        return;
+    }
+
+    /**
+     * Delete the input file.
+     */
+    void teardown(const benchmark::State&) {
+        std::remove(path.c_str());
+        return;
+    }
+}
+
+
+/**
+ * Count lines with std::getline().
+ */
+static void BM_getline(benchmark::State& state) {
+    for (auto _: state) {
+        std::ifstream file{path};
+        std::string line;
+        size_t count{0};
+        while (std::getline(file, line)) {
+            ++count;
+        }
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * file_size));
+    return;
+}
+BENCHMARK(BM_getline)->Setup(setup)->Teardown(teardown)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+
+/**
+ * Count lines with a ChunkReader.
+ */
+static void BM_chunks(benchmark::State& state) {
+    for (auto _: state) {
+        const ChunkReader reader{path};
+        const auto count{reader.reduce(size_t{0}, [](std::string_view chunk) {
+            return static_cast<size_t>(std::count(chunk.begin(), chunk.end(), '\n'));
+        }, std::plus<>{})};
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * file_size));
+    return;
+}
+BENCHMARK(BM_chunks)->Setup(setup)->Teardown(teardown)->Unit(benchmark::kMillisecond)->UseRealTime();
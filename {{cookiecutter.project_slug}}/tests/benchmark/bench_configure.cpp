@@ -0,0 +1,93 @@
+/**
+ * Benchmarks for the configure module.
+ *
+ * Config lookups are on the startup path of every command, so these are used
+ * to compare build options such as LTO; see `make bench-compare`.
+ */
+#include <benchmark/benchmark.h>
+#include <string>
+#include <tuple>
+#include "core/configure.hpp"
+
+using configure::Config;
+using configure::field;
+
+
+namespace {
+
+    const std::string text{R"(
+[logging]
+level = "warn"
+
+[threads]
+workers = 4
+affinity = false
+)"};
+
+    struct Settings {
+        std::string level;
+        unsigned workers;
+        bool affinity;
+    };
+}
+
+
+/**
+ * Config fields for Settings.
+ */
+template <>
+struct configure::Schema<Settings> {
+    static constexpr auto fields{std::make_tuple(
+        field("logging.level", &Settings::level),
+        field("threads.workers", &Settings::workers),
+        field("threads.affinity", &Settings::affinity)
+    )};
+};
+
+
+/**
+ * Parse config text.
+ */
+static void BM_config_load(benchmark::State& state) {
+    for (auto _: state) {
+        Config config;
+        config.load_text(text);
+        benchmark::DoNotOptimize(&config);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    return;
+}
+BENCHMARK(BM_config_load);
+
+
+/**
+ * Look up a value.
+ */
+static void BM_config_lookup(benchmark::State& state) {
+    Config config;
+    config.load_text(text);
+    const auto& data{config};
+    const std::string key{"threads.workers"};
+    for (auto _: state) {
+        benchmark::DoNotOptimize(data[key].data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    return;
+}
+BENCHMARK(BM_config_lookup);
+
+
+/**
+ * Convert values to a settings struct.
+ */
+static void BM_config_get(benchmark::State& state) {
+    Config config;
+    config.load_text(text);
+    for (auto _: state) {
+        const auto settings{config.get<Settings>()};
+        benchmark::DoNotOptimize(settings.workers);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    return;
+}
+BENCHMARK(BM_config_get);
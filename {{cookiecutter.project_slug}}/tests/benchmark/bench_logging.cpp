@@ -0,0 +1,54 @@
+/**
+ * Benchmarks for the logging module.
+ *
+ * These are the logger calls made by every command, so they are used to
+ * compare build options such as LTO; see `make bench-compare`.
+ */
+#include <benchmark/benchmark.h>
+#include <sstream>
+#include <string>
+#include "core/logging.hpp"
+
+using Logging::Logger;
+
+
+namespace {
+
+    const std::string message{"benchmark message"};
+}
+
+
+/**
+ * Log a message below the logger level, which is ignored.
+ */
+static void BM_log_filtered(benchmark::State& state) {
+    Logger logger{"bench"};
+    std::ostringstream stream;
+    logger.start(Logging::WARN, stream);
+    for (auto _: state) {
+        logger.debug(message);
+        benchmark::ClobberMemory();  // reload the logger state each time
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    return;
+}
+BENCHMARK(BM_log_filtered);
+
+
+/**
+ * Log a message that is written to a stream.
+ */
+static void BM_log_emit(benchmark::State& state) {
+    Logger logger{"bench"};
+    std::ostringstream stream;
+    logger.start(Logging::WARN, stream);
+    for (auto _: state) {
+        logger.warn(message);
+        if (stream.tellp() > 1 << 20) {
+            stream.str("");
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    return;
+}
+BENCHMARK(BM_log_emit);
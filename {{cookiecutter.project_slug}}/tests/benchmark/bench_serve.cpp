@@ -0,0 +1,106 @@
+/**
+ * Benchmarks for the serve subcommand.
+ *
+ * Compare the latency of a cold invocation of the application with a request
+ * to a running server.
+ */
+#include <benchmark/benchmark.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "core/UnixSocket.hpp"
+
+using std::string;
+using std::vector;
+
+extern char** environ;
+
+
+namespace {
+
+    /**
+     * Start the application.
+     *
+     * @param args application arguments
+     * @return process ID
+     */
+    pid_t spawn(vector<string> args) {
+        args.insert(args.begin(), APP_PATH);
+        vector<char*> argv;
+        for (auto& arg: args) {
+            argv.push_back(arg.data());
+        }
+        argv.push_back(nullptr);
+        pid_t pid;
+        if (posix_spawn(&pid, APP_PATH, nullptr, nullptr, argv.data(), environ) != 0) {
+            throw std::runtime_error("could not execute " APP_PATH);
+        }
+        return pid;
+    }
+
+    /**
+     * Wait for a process to exit.
+     *
+     * @param pid process ID
+     * @return exit status
+     */
+    int wait(pid_t pid) {
+        int status;
+        waitpid(pid, &status, 0);
+        return WIFEXITED(status) ? WEXITSTATUS(status) : EXIT_FAILURE;
+    }
+}
+
+
+/**
+ * Execute a subcommand in a new process.
+ */
+static void BM_cold(benchmark::State& state) {
+    for (auto _: state) {
+        if (wait(spawn({"cmd1"})) != EXIT_SUCCESS) {
+            state.SkipWithError("cmd1 failed");
+            break;
+        }
+    }
+    return;
+}
+BENCHMARK(BM_cold)->Unit(benchmark::kMicrosecond);
+
+
+/**
+ * Execute a subcommand in a running server.
+ */
+static void BM_serve(benchmark::State& state) {
+    char dir[]{"/tmp/bench_serve.XXXXXX"};
+    if (not mkdtemp(dir)) {
+        state.SkipWithError("cannot create temporary directory");
+        return;
+    }
+    const auto socket_path{string{dir} + "/serve.sock"};
+    const auto server{spawn({"serve", "--socket", socket_path})};
+    for (auto tries{0}; tries < 500 and not std::filesystem::exists(socket_path); ++tries) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    const auto client{UnixSocket::connect(socket_path)};
+    const UnixSocket::Message request{"cmd1"};
+    UnixSocket::Message response;
+    for (auto _: state) {
+        client.send(request);
+        if (not client.recv(response) or response.front() != "0") {
+            state.SkipWithError("cmd1 failed");
+            break;
+        }
+    }
+    client.send({});  // stop server
+    client.recv(response);
+    wait(server);
+    std::filesystem::remove_all(dir);
+    return;
+}
+BENCHMARK(BM_serve)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,134 @@
+/**
+ * Startup latency benchmark.
+ *
+ * Execute a command repeatedly and report the distribution of its wall time
+ * and page faults. This is a standalone program rather than a Google
+ * Benchmark so that it can fail a build when the startup budget is exceeded.
+ *
+ * Usage: startup_{{ cookiecutter.app_name }} RUNS BUDGET_MS COMMAND [ARGS...]
+ *
+ * The exit status is nonzero if the p99 wall time exceeds BUDGET_MS or the
+ * command fails.
+ */
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using std::cerr;
+using std::cout;
+using std::string;
+using std::vector;
+
+extern char** environ;
+
+
+namespace {
+
+    /**
+     * Resource usage for one run.
+     */
+    struct Sample {
+        double wall;  // ms
+        long minor;  // page faults
+        long major;
+        long rss;  // max KiB
+    };
+
+    /**
+     * Execute a command once.
+     *
+     * Output from the command is discarded.
+     *
+     * @param argv command arguments, terminated by nullptr
+     * @param sample resource usage
+     * @return true if the command was successful
+     */
+    bool run(const vector<char*>& argv, Sample& sample) {
+        posix_spawn_file_actions_t actions;
+        posix_spawn_file_actions_init(&actions);
+        posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+        posix_spawn_file_actions_addopen(&actions, STDERR_FILENO, "/dev/null", O_WRONLY, 0);
+        const auto start{std::chrono::steady_clock::now()};
+        pid_t pid;
+        const auto error{posix_spawn(&pid, argv[0], &actions, nullptr, argv.data(), environ)};
+        posix_spawn_file_actions_destroy(&actions);
+        if (error != 0) {
+            return false;
+        }
+        int status;
+        rusage usage{};
+        wait4(pid, &status, 0, &usage);
+        const std::chrono::duration<double, std::milli> wall{std::chrono::steady_clock::now() - start};
+        sample = {wall.count(), usage.ru_minflt, usage.ru_majflt, usage.ru_maxrss};
+        return WIFEXITED(status) and WEXITSTATUS(status) == EXIT_SUCCESS;
+    }
+
+    /**
+     * Get a percentile of a set of values.
+     *
+     * @param values values to sort
+     * @param percent percentile in the range [0, 100]
+     * @return nearest-rank percentile
+     */
+    template <typename T>
+    T percentile(vector<T> values, double percent) {
+        std::sort(values.begin(), values.end());
+        const auto rank{static_cast<size_t>(percent / 100 * static_cast<double>(values.size()) + 0.5)};
+        return values[std::clamp(rank, size_t{1}, values.size()) - 1];
+    }
+}
+
+
+/**
+ * Run the benchmark.
+ *
+ * @param argc size of argv
+ * @param argv RUNS BUDGET_MS COMMAND [ARGS...]
+ * @return EXIT_SUCCESS if the budget was met
+ */
+int main(int argc, char* argv[]) {
+    if (argc < 4) {
+        cerr << "usage: " << argv[0] << " RUNS BUDGET_MS COMMAND [ARGS...]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    const auto runs{std::max(std::stoul(argv[1]), 1ul)};
+    const auto budget{std::stod(argv[2])};
+    const vector<char*> command(argv + 3, argv + argc + 1);  // include nullptr
+    Sample sample;
+    if (not run(command, sample)) {  // warm up the page cache
+        cerr << "command failed: " << argv[3] << std::endl;
+        return EXIT_FAILURE;
+    }
+    vector<double> wall;
+    vector<long> minor;
+    vector<long> major;
+    vector<long> rss;
+    for (size_t count{0}; count < runs; ++count) {
+        if (not run(command, sample)) {
+            cerr << "command failed: " << argv[3] << std::endl;
+            return EXIT_FAILURE;
+        }
+        wall.push_back(sample.wall);
+        minor.push_back(sample.minor);
+        major.push_back(sample.major);
+        rss.push_back(sample.rss);
+    }
+    const auto p99{percentile(wall, 99)};
+    cout << std::fixed << std::setprecision(3);
+    cout << "runs:                 " << runs << '\n';
+    cout << "wall ms p50/p99:      " << percentile(wall, 50) << " / " << p99 << '\n';
+    cout << "minor faults p50/p99: " << percentile(minor, 50) << " / " << percentile(minor, 99) << '\n';
+    cout << "major faults p50/p99: " << percentile(major, 50) << " / " << percentile(major, 99) << '\n';
+    cout << "max RSS KiB p50:      " << percentile(rss, 50) << '\n';
+    const auto passed{p99 <= budget};
+    cout << "budget p99 <= " << budget << " ms: " << (passed ? "pass" : "FAIL") << std::endl;
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
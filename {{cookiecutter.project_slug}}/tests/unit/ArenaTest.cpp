@@ -0,0 +1,69 @@
+/**
+ * Test suite for the Arena class.
+ *
+ * Link all test files with the `gtest_main` library to create a command-line
+ * test runner.
+ */
+#include "core/Arena.hpp"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+
+/**
+ * Test allocation.
+ */
+TEST(ArenaTest, allocate) {
+    Arena arena{1024};
+    ASSERT_EQ(arena.capacity(), 0);
+    for (const size_t alignment: {1, 8, 64}) {
+        const auto ptr{arena.allocate(10, alignment)};
+        ASSERT_EQ(reinterpret_cast<std::uintptr_t>(ptr) % alignment, 0);
+    }
+    ASSERT_EQ(arena.capacity(), 1024);
+    static_cast<void>(arena.allocate(4096));  // larger than a block
+    ASSERT_GE(arena.capacity(), 1024 + 4096);
+    std::pmr::vector<std::pmr::string> strings{&arena};
+    strings.emplace_back("a string that is too long for the small string optimization");
+    ASSERT_EQ(strings.front().get_allocator().resource(), &arena);
+}
+
+
+/**
+ * Test the reset() method.
+ */
+TEST(ArenaTest, reset) {
+    Arena arena{1024};
+    const auto first{arena.allocate(512)};
+    static_cast<void>(arena.allocate(1000));  // uses a second block
+    const auto capacity{arena.capacity()};
+    arena.reset();
+    ASSERT_EQ(arena.allocate(512), first);
+    static_cast<void>(arena.allocate(1000));
+    ASSERT_EQ(arena.capacity(), capacity);  // blocks were reused
+}
+
+
+/**
+ * Test the Scope class.
+ */
+TEST(ArenaTest, scope) {
+    ASSERT_EQ(Arena::current(), std::pmr::get_default_resource());
+    Arena arena;
+    void* outer;
+    {
+        const Arena::Scope scope{arena};
+        ASSERT_EQ(Arena::current(), &arena);
+        outer = arena.allocate(16);
+        void* inner;
+        {
+            const Arena::Scope scope{arena};  // nested
+            inner = arena.allocate(16);
+        }
+        ASSERT_EQ(arena.allocate(16), inner);  // rewound to outer mark
+    }
+    ASSERT_EQ(Arena::current(), std::pmr::get_default_resource());
+    ASSERT_EQ(arena.allocate(16), outer);
+}
@@ -0,0 +1,122 @@
+/**
+ * Test suite for the async module.
+ *
+ * Link all test files with the `gtest_main` library to create a command-line
+ * test runner.
+ */
+#include "core/async.hpp"
+#include <gtest/gtest.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+using async::EventLoop;
+using async::Task;
+using std::string;
+using testing::TestWithParam;
+using testing::Values;
+
+
+namespace {
+
+    Task<int> answer() {
+        co_return 42;
+    }
+
+    Task<int> twice() {
+        const auto value{co_await answer()};
+        co_return 2 * value;
+    }
+
+    Task<> fail() {
+        throw std::runtime_error("error");
+        co_return;
+    }
+
+    /**
+     * Write a string to a file descriptor, then read it back.
+     */
+    Task<string> copy(EventLoop& loop, int fd, string data) {
+        auto count{co_await loop.write(fd, data.data(), data.size(), 0)};
+        string buffer(count, '\0');
+        count = co_await loop.read(fd, buffer.data(), buffer.size(), 0);
+        buffer.resize(count);
+        co_return buffer;
+    }
+
+    Task<> send(EventLoop& loop, int fd, const string& data) {
+        co_await loop.write(fd, data.data(), data.size());
+        close(fd);
+    }
+
+    Task<string> recv(EventLoop& loop, int fd) {
+        string data;
+        char buffer[4];
+        while (const auto count{co_await loop.read(fd, buffer, sizeof(buffer))}) {
+            data.append(buffer, count);
+        }
+        co_return data;
+    }
+}
+
+
+/**
+ * Test fixture for the async test suite.
+ *
+ * Each test is run with io_uring, if available, and the fallback backend.
+ */
+class AsyncTest: public TestWithParam<bool> {
+protected:
+    EventLoop loop{GetParam()};
+};
+
+INSTANTIATE_TEST_SUITE_P(Backends, AsyncTest, Values(true, false));
+
+
+/**
+ * Test the backend() method.
+ */
+TEST_P(AsyncTest, backend) {
+    if (not GetParam()) {
+        ASSERT_EQ(string{loop.backend()}, "epoll");
+    }
+}
+
+
+/**
+ * Test nested tasks.
+ */
+TEST_P(AsyncTest, task) {
+    ASSERT_EQ(loop.run(twice()), 84);
+    ASSERT_THROW(loop.run(fail()), std::runtime_error);
+}
+
+
+/**
+ * Test file I/O.
+ */
+TEST_P(AsyncTest, file) {
+    char path[]{"/tmp/AsyncTest.XXXXXX"};
+    const auto fd{mkstemp(path)};
+    ASSERT_NE(fd, -1);
+    unlink(path);
+    ASSERT_EQ(loop.run(copy(loop, fd, "abc")), "abc");
+    ASSERT_THROW(loop.run(copy(loop, -1, "abc")), std::system_error);
+    close(fd);
+}
+
+
+/**
+ * Test concurrent stream I/O.
+ */
+TEST_P(AsyncTest, pipe) {
+    int fds[2];
+    ASSERT_EQ(::pipe(fds), 0);
+    const string data{"abcdefghijklmnopqrstuvwxyz"};
+    loop.spawn(send(loop, fds[1], data));
+    ASSERT_EQ(loop.run(recv(loop, fds[0])), data);
+    close(fds[0]);
+}
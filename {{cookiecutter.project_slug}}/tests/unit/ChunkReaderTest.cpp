@@ -0,0 +1,124 @@
+/**
+ * Test suite for the ChunkReader class.
+ *
+ * Link all test files with the `gtest_main` library to create a command-line
+ * test runner.
+ */
+#include "core/ChunkReader.hpp"
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+using std::string;
+using std::string_view;
+using std::vector;
+using testing::Test;
+
+
+/**
+ * Test fixture for the ChunkReader test suite.
+ *
+ * This is used to group tests and provide common set-up and tear-down code.
+ * A new test fixture is created for each test to prevent any side effects
+ * between tests. Member variables and methods are injected into each test that
+ * uses this fixture.
+ */
+class ChunkReaderTest: public Test {
+protected:
+    const string path{tmpfile()};
+    const string text{"line1\nline2\n\nlong line 4\nline5"};  // no final newline
+    ThreadPool pool{2};
+
+    /**
+     * Set up the test fixture.
+     */
+    ChunkReaderTest() {
+        std::ofstream{path} << text;
+    }
+
+    /**
+     * Tear down the test fixture.
+     */
+    ~ChunkReaderTest() override {
+        std::remove(path.c_str());
+    }
+
+    /**
+     * Create a unique temporary file.
+     *
+     * @return file path
+     */
+    static string tmpfile() {
+        char path[]{"/tmp/ChunkReaderTest.XXXXXX"};
+        const auto fd{mkstemp(path)};
+        if (fd == -1) {
+            throw std::system_error{errno, std::generic_category(), "cannot create temporary file"};
+        }
+        close(fd);
+        return path;
+    }
+};
+
+
+/**
+ * Test the chunks() method.
+ */
+TEST_F(ChunkReaderTest, chunks) {
+    for (const size_t size: {1, 8, 1024}) {
+        const ChunkReader reader{path, size, pool};
+        string joined;
+        for (const auto chunk: reader.chunks()) {
+            ASSERT_FALSE(chunk.empty());
+            if (chunk.data() + chunk.size() != reader.chunks().back().data() + reader.chunks().back().size()) {
+                ASSERT_EQ(chunk.back(), '\n');
+            }
+            joined += chunk;
+        }
+        ASSERT_EQ(joined, text);
+    }
+    std::ofstream{path, std::ios::trunc};
+    ASSERT_TRUE(ChunkReader(path, 8, pool).chunks().empty());
+    ASSERT_THROW(ChunkReader("none", 8, pool), std::system_error);
+}
+
+
+/**
+ * Test the map() method.
+ */
+TEST_F(ChunkReaderTest, map) {
+    const ChunkReader reader{path, 1, pool};
+    const auto lines{reader.map([](string_view chunk) {
+        vector<string> lines;
+        ChunkReader::lines(chunk, [&lines](string_view line) { lines.emplace_back(line); });
+        return lines;
+    })};
+    vector<string> merged;
+    for (const auto& chunk: lines) {
+        merged.insert(merged.end(), chunk.begin(), chunk.end());
+    }
+    ASSERT_EQ(merged, (vector<string>{"line1", "line2", "", "long line 4", "line5"}));
+}
+
+
+/**
+ * Test the reduce() method.
+ */
+TEST_F(ChunkReaderTest, reduce) {
+    const ChunkReader reader{path, 4, pool};
+    const auto count{reader.reduce(size_t{0}, [](string_view chunk) {
+        size_t count{0};
+        ChunkReader::lines(chunk, [&count](string_view) { ++count; });
+        return count;
+    }, std::plus<>{})};
+    ASSERT_EQ(count, 5);
+    const auto joined{reader.reduce(string{}, [](string_view chunk) { return string{chunk}; }, std::plus<>{})};
+    ASSERT_EQ(joined, text);  // merged in order
+}
@@ -4,14 +4,21 @@
  * Link all test files with the `gtest_main` library to create a command-line 
  * test runner.
  */
+#include <cassert>
 #include <cstring>  // strncpy
+#include <iostream>
+#include <memory_resource>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <gtest/gtest.h>
 #include "core/CommandLine.hpp"
 
 
 using std::string;
+using std::string_view;
 using std::strncpy;
 using std::vector;
 using testing::Test;
@@ -101,6 +108,19 @@ TEST_F(CommandLineTest, parse_pos_one) {
 }
 
 
+/**
+ * Test the parse() method for an exact number of positional arguments.
+ */
+TEST_F(CommandLineTest, parse_pos_exact) {
+    CommandLine cmdl{true};
+    cmdl.pos("pos", 2);
+    args({"cmd", "abc", "123"});
+    cmdl.parse(argc, argv);
+    ASSERT_EQ((vector<string>{"abc", "123"}), cmdl["pos"]);
+    return;
+}
+
+
 /**
  * Test the parse() method for all positional arguments.
  */
@@ -185,6 +205,127 @@ TEST_F(CommandLineTest, parse_opt_bool) {
 }
 
 
+/**
+ * Test the get() method.
+ */
+TEST_F(CommandLineTest, get) {
+    args({"cmd", "-b", "-n", "1", "--num=-2", "--real=1.5", "--str", "abc", "3"});
+    CommandLine cmdl;
+    cmdl.opt<bool>("bool", 'b');
+    cmdl.opt<int>("num", 'n');
+    cmdl.opt<double>("real");
+    cmdl.opt<string_view>("str");
+    cmdl.pos<unsigned>("pos");
+    cmdl.parse(argc, argv);
+    ASSERT_TRUE(cmdl.get<bool>("bool"));
+    ASSERT_FALSE(cmdl.get<bool>("none"));
+    ASSERT_EQ(-2, cmdl.get<int>("num"));  // last value
+    ASSERT_EQ(-2.0, cmdl.get<double>("num"));
+    ASSERT_EQ(1.5, cmdl.get<double>("real"));
+    ASSERT_EQ("abc", cmdl.get<string_view>("str"));
+    ASSERT_EQ(3, cmdl.get<char>("pos"));
+    ASSERT_THROW(cmdl.get<unsigned>("num"), std::out_of_range);
+    ASSERT_THROW(cmdl.get<int>("real"), std::logic_error);
+    ASSERT_THROW(cmdl.get<int>("str"), std::logic_error);
+    ASSERT_THROW(cmdl.get<int>("none"), std::out_of_range);
+    return;
+}
+
+
+/**
+ * Test the values() method.
+ */
+TEST_F(CommandLineTest, values) {
+    args({"cmd", "-n", "1", "-n2", "abc", "def"});
+    CommandLine cmdl;
+    cmdl.opt<long>("num", 'n');
+    cmdl.pos<string>("pos");
+    cmdl.parse(argc, argv);
+    const auto nums(cmdl.values<long>("num"));
+    ASSERT_EQ((vector<long>{1, 2}), (vector<long>{nums.begin(), nums.end()}));
+    const auto pos(cmdl.values<string_view>("pos"));
+    ASSERT_EQ(2, pos.size());
+    ASSERT_EQ((vector<string_view>{"abc", "def"}), (vector<string_view>{pos.begin(), pos.end()}));
+    ASSERT_TRUE(cmdl.values<string_view>("none").empty());
+    return;
+}
+
+
+/**
+ * Test the strings() method.
+ */
+TEST_F(CommandLineTest, strings) {
+    args({"cmd", "abc", "def"});
+    CommandLine cmdl;
+    cmdl.pos("pos");
+    cmdl.parse(argc, argv);
+    std::pmr::monotonic_buffer_resource arena;
+    const auto pos(cmdl.strings("pos", &arena));
+    ASSERT_EQ(pos.get_allocator().resource(), &arena);
+    ASSERT_EQ(pos.front().get_allocator().resource(), &arena);
+    ASSERT_EQ((vector<string>{pos.begin(), pos.end()}), cmdl["pos"]);
+    return;
+}
+
+
+/**
+ * Test the parse() method with invalid typed values.
+ */
+TEST_F(CommandLineTest, parse_type_err) {
+    CommandLine cmdl;
+    cmdl.opt<int>("num");
+    cmdl.pos<double>("pos");
+    args({"cmd", "--num=abc"});
+    ASSERT_THROW(cmdl.parse(argc, argv), std::runtime_error);
+    args({"cmd", "--num=1x"});
+    ASSERT_THROW(cmdl.parse(argc, argv), std::runtime_error);
+    args({"cmd", "--num=99999999999"});  // out of range for int
+    ASSERT_THROW(cmdl.parse(argc, argv), std::runtime_error);
+    args({"cmd", "abc"});
+    ASSERT_THROW(cmdl.parse(argc, argv), std::runtime_error);
+    return;
+}
+
+
+/**
+ * Test the parse() method with response files.
+ */
+TEST_F(CommandLineTest, parse_respfile) {
+    const string path{"tests/unit/assets/respfile.txt"};
+    args({"cmd", "-s", "@opt", "first", "@" + path, "last", "@-"});
+    CommandLine cmdl{false, true, true};
+    cmdl.opt("str", 's', true);
+    cmdl.pos("pos");
+    std::istringstream input{"xyz\n"};
+    const auto cinbuf(std::cin.rdbuf(input.rdbuf()));
+    cmdl.parse(argc, argv);
+    std::cin.rdbuf(cinbuf);
+    ASSERT_EQ((vector<string>{"@opt"}), cmdl["str"]);  // not positional
+    const vector<string> pos{"first", "abc", "def ghi", "jkl", "last", "xyz"};
+    ASSERT_EQ(pos, cmdl["pos"]);
+    const auto values(cmdl.values<string_view>("pos"));
+    ASSERT_EQ(pos.size(), values.size());
+    ASSERT_EQ(pos, (vector<string>{values.begin(), values.end()}));
+    ASSERT_EQ("xyz", cmdl.get<string_view>("pos"));
+    args({"cmd", "@tests/unit/assets/none"});
+    ASSERT_THROW(cmdl.parse(argc, argv), std::runtime_error);
+    return;
+}
+
+
+/**
+ * Test the parse() method with response files disabled.
+ */
+TEST_F(CommandLineTest, parse_respfile_off) {
+    args({"cmd", "@tests/unit/assets/none"});
+    CommandLine cmdl;
+    cmdl.pos("pos");
+    cmdl.parse(argc, argv);
+    ASSERT_EQ((vector<string>{"@tests/unit/assets/none"}), cmdl["pos"]);
+    return;
+}
+
+
 /**
  * Test the parse() method with '--' to end option processing.
  */
@@ -217,6 +358,19 @@ TEST_F(CommandLineTest, parse_opt_err) {
 }
 
 
+/**
+ * Test the opt() method with duplicate options.
+ */
+TEST_F(CommandLineTest, opt_dup) {
+    CommandLine cmdl;  // defines --help/-h
+    ASSERT_THROW(cmdl.opt("help"), std::invalid_argument);
+    ASSERT_THROW(cmdl.opt("other", 'h'), std::invalid_argument);
+    ASSERT_THROW(cmdl.opt("other", '\xff'), std::invalid_argument);
+    cmdl.opt("other", 'o');
+    return;
+}
+
+
 /**
  * Test the parse() method with subcommands.
  */
@@ -241,6 +395,57 @@ TEST_F(CommandLineTest, parse_subs) {
 }
 
 
+/**
+ * Test the parse() method without copying arguments.
+ */
+TEST_F(CommandLineTest, parse_nocopy) {
+    args({"cmd", "--str=abc", "def"});
+    CommandLine cmdl;
+    cmdl.opt("str", 's', true);
+    cmdl.pos("pos");
+    cmdl.parse(argc, argv, false);
+    ASSERT_EQ((vector<string>{"abc"}), cmdl["str"]);
+    ASSERT_EQ((vector<string>{"def"}), cmdl["pos"]);
+    argv[2][0] = 'x';  // values are views into argv
+    ASSERT_EQ((vector<string>{"xef"}), cmdl["pos"]);
+    return;
+}
+
+
+/**
+ * Test the parse() method for multiple command lines.
+ */
+TEST_F(CommandLineTest, parse_reuse) {
+    CommandLine cmdl;
+    cmdl.opt("str", 's', true);
+    cmdl.sub("sub1").pos("pos");
+    args({"cmd", "-s", "abc", "sub1", "123"});
+    cmdl.parse(argc, argv);
+    args({"cmd", "-s", "def"});
+    cmdl.parse(argc, argv);  // previous values are discarded
+    ASSERT_EQ((vector<string>{"def"}), cmdl["str"]);
+    ASSERT_FALSE(cmdl.has_arg("pos"));
+    ASSERT_TRUE(cmdl.subcommand().empty());
+    return;
+}
+
+
+/**
+ * Test the subcommand() method.
+ */
+TEST_F(CommandLineTest, subcommand) {
+    args({"cmd", "sub1", "sub2"});
+    CommandLine cmdl;
+    auto& sub1(cmdl.sub("sub1"));
+    sub1.sub("sub2");
+    cmdl.sub("sub3");
+    cmdl.parse(argc, argv);
+    ASSERT_EQ("sub1", cmdl.subcommand());
+    ASSERT_EQ("sub2", sub1.subcommand());
+    return;
+}
+
+
 /**
  * Test the parse() method with the help option.
  */
@@ -0,0 +1,68 @@
+/**
+ * Test suite for the MappedFile class.
+ *
+ * Link all test files with the `gtest_main` library to create a command-line
+ * test runner.
+ */
+#include "core/MappedFile.hpp"
+#include <gtest/gtest.h>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <system_error>
+#include <utility>
+
+using std::ifstream;
+using std::istreambuf_iterator;
+using std::string;
+using testing::Test;
+
+
+/**
+ * Test fixture for the MappedFile test suite.
+ *
+ * This is used to group tests and provide common set-up and tear-down code.
+ * A new test fixture is created for each test to prevent any side effects
+ * between tests. Member variables and methods are injected into each test that
+ * uses this fixture.
+ */
+class MappedFileTest: public Test {
+protected:
+    const std::string path{"tests/unit/assets/config.toml"};
+
+    /**
+     * Read the test file using a stream.
+     */
+    string read() const {
+        ifstream stream{path};
+        return {istreambuf_iterator<char>{stream}, istreambuf_iterator<char>{}};
+    }
+};
+
+
+/**
+ * Test the view() method.
+ */
+TEST_F(MappedFileTest, view) {
+    const MappedFile file{path};
+    ASSERT_EQ(file.view(), read());
+}
+
+
+/**
+ * Test the move constructor.
+ */
+TEST_F(MappedFileTest, move) {
+    MappedFile file{path};
+    const MappedFile other{std::move(file)};
+    ASSERT_TRUE(file.view().empty());
+    ASSERT_EQ(other.view(), read());
+}
+
+
+/**
+ * Test error handling.
+ */
+TEST_F(MappedFileTest, error) {
+    ASSERT_THROW(MappedFile{"tests/unit/assets/none"}, std::system_error);
+}
@@ -0,0 +1,44 @@
+/**
+ * Test suite for the PerfCounters class.
+ *
+ * Link all test files with the `gtest_main` library to create a command-line
+ * test runner.
+ */
+#include "core/PerfCounters.hpp"
+#include <gtest/gtest.h>
+
+
+/**
+ * Test counting events.
+ *
+ * This is skipped if the kernel does not allow access to the counters.
+ */
+TEST(PerfCountersTest, stop) {
+    PerfCounters counters;
+    if (not counters.available()) {
+        ASSERT_FALSE(counters.error().empty());
+        GTEST_SKIP() << counters.error();
+    }
+    counters.start();
+    volatile unsigned value{0};
+    for (unsigned count{0}; count < 100000; ++count) {
+        value = value + count;
+    }
+    const auto sample{counters.stop()};
+    if (sample.valid[PerfCounters::INSTRUCTIONS]) {
+        ASSERT_GT(sample[PerfCounters::INSTRUCTIONS], 100000);
+    }
+    if (sample.valid[PerfCounters::CYCLES] and sample.valid[PerfCounters::INSTRUCTIONS]) {
+        ASSERT_GT(sample.ipc(), 0);
+    }
+}
+
+
+/**
+ * Test an empty sample.
+ */
+TEST(PerfCountersTest, ipc) {
+    const PerfCounters::Sample sample;
+    ASSERT_EQ(sample.ipc(), 0);
+    ASSERT_EQ(sample[PerfCounters::CYCLES], 0);
+}
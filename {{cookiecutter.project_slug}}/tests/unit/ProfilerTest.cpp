@@ -0,0 +1,84 @@
+/**
+ * Test suite for the Profiler class.
+ *
+ * Link all test files with the `gtest_main` library to create a command-line
+ * test runner.
+ */
+#include "core/Profiler.hpp"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <ctime>
+#include <regex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+using std::string;
+
+
+namespace {
+    /**
+     * Use CPU time.
+     *
+     * @param millis CPU time to use
+     * @return meaningless value to prevent optimization
+     */
+    double spin(long millis) {
+        const auto end{std::clock() + millis * CLOCKS_PER_SEC / 1000};
+        volatile double value{0};
+        while (std::clock() < end) {
+            value = value + 1;
+        }
+        return value;
+    }
+}
+
+
+/**
+ * Test sampling and folded-stack output.
+ */
+TEST(ProfilerTest, write) {
+    Profiler profiler{1000};
+    profiler.start();
+    spin(200);
+    profiler.stop();
+    ASSERT_GT(profiler.samples(), 0);
+    ASSERT_EQ(profiler.dropped(), 0);
+    std::ostringstream stream;
+    profiler.write(stream);
+    const std::regex folded{R"(\S.* \d+)"};
+    std::istringstream lines{stream.str()};
+    size_t count{0};
+    for (string line; std::getline(lines, line);) {
+        ASSERT_TRUE(std::regex_match(line, folded)) << line;
+        count += std::stoul(line.substr(line.rfind(' ') + 1));
+    }
+    ASSERT_EQ(count, profiler.samples());
+}
+
+
+/**
+ * Test that samples are dropped when the buffer is full.
+ */
+TEST(ProfilerTest, dropped) {
+    Profiler profiler{1000, 1};
+    profiler.start();
+    spin(100);
+    profiler.stop();
+    ASSERT_EQ(profiler.samples(), 1);
+    ASSERT_GT(profiler.dropped(), 0);
+}
+
+
+/**
+ * Test that only one profiler can run at a time.
+ */
+TEST(ProfilerTest, start) {
+    Profiler profiler;
+    profiler.start();
+    Profiler other;
+    ASSERT_THROW(other.start(), std::logic_error);
+    profiler.stop();
+    other.start();
+    other.stop();
+}
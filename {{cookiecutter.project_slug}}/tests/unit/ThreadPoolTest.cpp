@@ -0,0 +1,107 @@
+/**
+ * Test suite for the ThreadPool class.
+ *
+ * Link all test files with the `gtest_main` library to create a command-line
+ * test runner.
+ */
+#include "core/ThreadPool.hpp"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using std::vector;
+
+
+/**
+ * Test the submit() method.
+ */
+TEST(ThreadPoolTest, submit) {
+    ThreadPool pool{2};
+    auto future{pool.submit([]() { return 123; })};
+    ASSERT_EQ(pool.wait(future), 123);
+    auto error{pool.submit([]() { throw std::runtime_error("error"); })};
+    ASSERT_THROW(pool.wait(error), std::runtime_error);
+}
+
+
+/**
+ * Test the parallel_for() method.
+ */
+TEST(ThreadPoolTest, parallel_for) {
+    ThreadPool pool{4};
+    vector<int> values(1000);
+    pool.parallel_for(size_t{0}, values.size(), [&values](size_t index) {
+        values[index] = static_cast<int>(index);
+    });
+    for (size_t index{0}; index < values.size(); ++index) {
+        ASSERT_EQ(values[index], index);
+    }
+    const auto error([](int index) {
+        if (index == 500) {
+            throw std::runtime_error("error");
+        }
+    });
+    ASSERT_THROW(pool.parallel_for(0, 1000, error), std::runtime_error);
+}
+
+
+/**
+ * Test the parallel_reduce() method.
+ */
+TEST(ThreadPoolTest, parallel_reduce) {
+    ThreadPool pool{4};
+    const auto map([](long index) { return index; });
+    const auto sum(pool.parallel_reduce(0L, 10000L, 0L, map, std::plus<>{}));
+    ASSERT_EQ(sum, 49995000L);
+    ASSERT_EQ(pool.parallel_reduce(0L, 0L, 1L, map, std::plus<>{}), 1L);
+}
+
+
+/**
+ * Test nested parallel loops.
+ */
+TEST(ThreadPoolTest, nested) {
+    ThreadPool pool{2};  // fewer workers than outer tasks
+    std::atomic<int> count{0};
+    pool.parallel_for(0, 8, [&pool, &count](int) {
+        pool.parallel_for(0, 100, [&count](int) { ++count; });
+    });
+    ASSERT_EQ(count, 800);
+}
+
+
+/**
+ * Test the stop() method.
+ */
+TEST(ThreadPoolTest, stop) {
+    ThreadPool pool;
+    ASSERT_EQ(pool.size(), std::max(std::thread::hardware_concurrency(), 1u));
+    std::atomic<int> count{0};
+    vector<std::future<void>> futures;
+    for (int task{0}; task < 100; ++task) {
+        futures.push_back(pool.submit([&count]() { ++count; }));
+    }
+    pool.stop();  // finish pending tasks
+    ASSERT_EQ(count, 100);
+    pool.start(1);
+    ASSERT_EQ(pool.size(), 1);
+    auto future{pool.submit([]() { return 1; })};  // restart
+    ASSERT_EQ(pool.wait(future), 1);
+}
+
+
+/**
+ * Test the thread_pool() accessor.
+ */
+TEST(ThreadPoolTest, global) {
+    // Every thread must get the same instance.
+    ThreadPool* other{nullptr};
+    std::thread thread{[&other]() { other = &thread_pool(); }};
+    thread.join();
+    ASSERT_EQ(&thread_pool(), other);
+    auto future{thread_pool().submit([]() { return 1; })};
+    ASSERT_EQ(thread_pool().wait(future), 1);
+}
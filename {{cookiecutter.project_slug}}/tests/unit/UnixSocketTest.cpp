@@ -0,0 +1,189 @@
+/**
+ * Test suite for the UnixSocket class.
+ *
+ * Link all test files with the `gtest_main` library to create a command-line
+ * test runner.
+ */
+#include "core/UnixSocket.hpp"
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include <vector>
+
+using std::string;
+using std::system_error;
+using testing::Test;
+
+
+/**
+ * Test fixture for the UnixSocket test suite.
+ *
+ * This is used to group tests and provide common set-up and tear-down code.
+ * A new test fixture is created for each test to prevent any side effects
+ * between tests. Member variables and methods are injected into each test that
+ * uses this fixture.
+ */
+class UnixSocketTest: public Test {
+protected:
+    /**
+     * Create a unique directory for the socket file.
+     */
+    UnixSocketTest() {
+        char dir[]{"/tmp/UnixSocketTest.XXXXXX"};
+        if (not mkdtemp(dir)) {
+            throw system_error{errno, std::generic_category(), "cannot create temporary directory"};
+        }
+        path = string{dir} + "/test.sock";
+    }
+
+    /**
+     * Remove the socket directory.
+     */
+    ~UnixSocketTest() {
+        std::error_code err;
+        std::filesystem::remove_all(std::filesystem::path{path}.parent_path(), err);
+    }
+
+    /**
+     * Connect to the socket without the UnixSocket protocol.
+     *
+     * @return socket descriptor
+     */
+    int raw_connect() const {
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::strcpy(addr.sun_path, path.c_str());
+        const auto fd{socket(AF_UNIX, SOCK_STREAM, 0)};
+        if (fd == -1 or connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == -1) {
+            throw system_error{errno, std::generic_category(), "cannot connect"};
+        }
+        return fd;
+    }
+
+    /**
+     * Get the error code for a failed receive.
+     *
+     * @param header raw message header to send
+     * @return error code
+     */
+    std::error_code recv_error(const std::vector<std::uint32_t>& header) const {
+        const auto server{UnixSocket::listen(path)};
+        const auto fd{raw_connect()};
+        const auto size{header.size() * sizeof(std::uint32_t)};
+        EXPECT_EQ(write(fd, header.data(), size), static_cast<ssize_t>(size));
+        const auto client{server.accept()};
+        UnixSocket::Message message;
+        std::error_code code;
+        try {
+            client.recv(message);
+        }
+        catch (const system_error& ex) {
+            code = ex.code();
+        }
+        close(fd);
+        return code;
+    }
+
+    string path;
+};
+
+
+/**
+ * Test sending and receiving messages.
+ */
+TEST_F(UnixSocketTest, message) {
+    const auto server{UnixSocket::listen(path)};
+    const auto client{UnixSocket::connect(path)};
+    const auto peer{server.accept()};
+    const UnixSocket::Message request{"cmd1", "", string(1000, 'x')};
+    client.send(request);
+    client.send({});
+    UnixSocket::Message message;
+    ASSERT_TRUE(peer.recv(message));
+    ASSERT_EQ(message, request);
+    ASSERT_TRUE(peer.recv(message));
+    ASSERT_TRUE(message.empty());
+}
+
+
+/**
+ * Test that oversized messages are rejected without allocating them.
+ */
+TEST_F(UnixSocketTest, oversized) {
+    const auto count{static_cast<std::uint32_t>(UnixSocket::max_strings + 1)};
+    ASSERT_EQ(recv_error({0xFFFFFFFF}), std::errc::message_size);
+    ASSERT_EQ(recv_error({count}), std::errc::message_size);
+    ASSERT_EQ(recv_error({2, 0, 0xFFFFFFFF}), std::errc::message_size);
+    const auto server{UnixSocket::listen(path)};
+    const auto client{UnixSocket::connect(path)};
+    const UnixSocket::Message message{string(UnixSocket::max_bytes + 1, 'x')};
+    try {
+        client.send(message);
+        FAIL() << "expected an exception";
+    }
+    catch (const system_error& ex) {
+        ASSERT_EQ(ex.code(), std::errc::message_size);
+    }
+}
+
+
+/**
+ * Test that a server does not replace another running server.
+ */
+TEST_F(UnixSocketTest, listen) {
+    {
+        const auto server{UnixSocket::listen(path)};
+        try {
+            UnixSocket::listen(path);
+            FAIL() << "expected an exception";
+        }
+        catch (const system_error& ex) {
+            ASSERT_EQ(ex.code(), std::errc::address_in_use);
+        }
+        ASSERT_NO_THROW(UnixSocket::connect(path));  // still listening
+    }
+    ASSERT_FALSE(std::filesystem::exists(path));
+    {
+        // Leave a stale socket file.
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::strcpy(addr.sun_path, path.c_str());
+        const auto fd{socket(AF_UNIX, SOCK_STREAM, 0)};
+        ASSERT_EQ(bind(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)), 0);
+        close(fd);
+    }
+    ASSERT_TRUE(std::filesystem::is_socket(path));
+    ASSERT_NO_THROW(UnixSocket::listen(path));
+}
+
+
+/**
+ * Test the timeout() method.
+ */
+TEST_F(UnixSocketTest, timeout) {
+    const auto server{UnixSocket::listen(path)};
+    const auto client{UnixSocket::connect(path)};
+    const auto peer{server.accept()};
+    peer.timeout(std::chrono::milliseconds(50));
+    UnixSocket::Message message;
+    try {
+        peer.recv(message);  // client is idle
+        FAIL() << "expected an exception";
+    }
+    catch (const system_error& ex) {
+        ASSERT_EQ(ex.code(), std::errc::timed_out);
+    }
+    peer.timeout(std::chrono::milliseconds(0));  // no limit
+    client.send({"cmd1"});
+    ASSERT_TRUE(peer.recv(message));
+    ASSERT_EQ(message, UnixSocket::Message{"cmd1"});
+}
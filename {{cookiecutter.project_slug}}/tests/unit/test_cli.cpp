@@ -4,11 +4,25 @@
  * Link all test files with the `gtest_main` library to create a command-line
  * test runner.
  */
+#include "core/Profiler.hpp"
+#include "core/UnixSocket.hpp"
 #include <gtest/gtest.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <chrono>
 #include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
 #include <iostream>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <system_error>
+#include <thread>
 #include <vector>
 
 using std::clog;
@@ -22,6 +36,75 @@ using testing::Test;
 
 extern int cli(int, char* []);  // defined in cli.cpp
 
+extern char** environ;
+
+
+namespace {
+
+    /**
+     * Run the application in a child process.
+     *
+     * The process is terminated when this object is destroyed if it is still
+     * running, e.g. after a failed assertion.
+     */
+    class Process {
+    public:
+        /**
+         * Start the application.
+         *
+         * @param args application arguments
+         * @param output file for STDOUT and STDERR, or empty to inherit them
+         */
+        explicit Process(vector<string> args, const string& output="") {
+            args.insert(args.begin(), APP_PATH);
+            vector<char*> argv;
+            for (auto& arg: args) {
+                argv.push_back(arg.data());
+            }
+            argv.push_back(nullptr);
+            posix_spawn_file_actions_t actions;
+            posix_spawn_file_actions_init(&actions);
+            if (not output.empty()) {
+                posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, output.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+                posix_spawn_file_actions_adddup2(&actions, STDOUT_FILENO, STDERR_FILENO);
+            }
+            const auto error{posix_spawn(&pid, APP_PATH, &actions, nullptr, argv.data(), environ)};
+            posix_spawn_file_actions_destroy(&actions);
+            if (error != 0) {
+                throw std::system_error{error, std::generic_category(), "could not execute " APP_PATH};
+            }
+        }
+
+        Process(const Process&) = delete;
+        Process& operator=(const Process&) = delete;
+
+        /**
+         * Terminate the process if it is still running.
+         */
+        ~Process() {
+            if (pid > 0) {
+                kill(pid, SIGTERM);
+                wait();
+            }
+        }
+
+        /**
+         * Wait for the process to exit.
+         *
+         * @return exit status
+         */
+        int wait() {
+            int status;
+            waitpid(pid, &status, 0);
+            pid = -1;
+            return WIFEXITED(status) ? WEXITSTATUS(status) : EXIT_FAILURE;
+        }
+
+    private:
+        pid_t pid{-1};
+    };
+}
+
 
 /**
  * Test fixture for the cli module test suite.
@@ -51,6 +134,10 @@ protected:
         dealloc(); 
         cout.rdbuf(outbuf);
         clog.rdbuf(errbuf);
+        for (const auto& path: tmpdirs) {
+            std::error_code err;
+            std::filesystem::remove_all(path, err);  // ignore errors
+        }
     }
 
     /**
@@ -68,6 +155,23 @@ protected:
         }
         return;
     }
+
+    /**
+     * Create a unique temporary directory.
+     *
+     * The directory is removed when the fixture is destroyed, so tests can
+     * run concurrently without sharing files.
+     *
+     * @return directory path
+     */
+    string tmpdir() {
+        char path[]{"/tmp/CliTest.XXXXXX"};
+        if (not mkdtemp(path)) {
+            throw std::system_error{errno, std::generic_category(), "cannot create temporary directory"};
+        }
+        tmpdirs.emplace_back(path);
+        return tmpdirs.back();
+    }
     
     int argc{0};
     char** argv{nullptr};
@@ -77,6 +181,8 @@ protected:
     streambuf* const errbuf;
     
 private:
+    vector<string> tmpdirs;
+
     /**
      * Deallocate argv.
      */
@@ -132,6 +238,25 @@ TEST_F(CliTest, warn) {
 }
 
 
+/**
+ * Test the --config option.
+ */
+TEST_F(CliTest, config) {
+    const auto path{tmpdir() + "/config.toml"};
+    std::ofstream{path} << "[logging]\nlevel = \"info\"\n";
+    for (auto flag: vector<string>{"-c", "--config"}) {
+        cmdl({"{{ cookiecutter.app_name }}", flag, path, "cmd1"});
+        ASSERT_EQ(cli(argc, argv), EXIT_SUCCESS);
+        ASSERT_NE(stderr.str().find("application complete"), string::npos);  // INFO
+        stderr.str("");
+    }
+    cmdl({"{{ cookiecutter.app_name }}", "--config", path + ".missing", "cmd1"});
+    ASSERT_EQ(cli(argc, argv), EXIT_FAILURE);
+    ASSERT_NE(stderr.str().find("could not load"), string::npos);
+    return;
+}
+
+
 /**
  * Test invalid options.
  */
@@ -145,6 +270,17 @@ TEST_F(CliTest, invalid) {
 }
 
 
+/**
+ * Test an unknown subcommand.
+ */
+TEST_F(CliTest, unknown) {
+    cmdl({"{{ cookiecutter.app_name }}", "cmd0"});
+    ASSERT_EQ(cli(argc, argv), EXIT_FAILURE);
+    ASSERT_NE(stdout.str().find("cmd1"), string::npos);
+    return;
+}
+
+
 /**
  * Test subcommand arguments.
  */
@@ -156,3 +292,209 @@ TEST_F(CliTest, subcommand) {
     }
     return;
 }
+
+
+/**
+ * Test the --metrics option.
+ */
+TEST_F(CliTest, metrics) {
+    cmdl({"{{ cookiecutter.app_name }}", "--metrics", "cmd1"});
+    ASSERT_EQ(cli(argc, argv), EXIT_SUCCESS);
+    ASSERT_NE(stderr.str().find("command.cmd1.duration_ns count="), string::npos);
+    return;
+}
+
+
+/**
+ * Test that only executed subcommands are added to the metrics registry.
+ */
+TEST_F(CliTest, metrics_lazy) {
+    // Other tests execute every subcommand in this process, so the registry
+    // is checked in a new process.
+    const auto path{tmpdir() + "/output.txt"};
+    Process app{vector<string>{"--metrics", "cmd1"}, path};
+    ASSERT_EQ(app.wait(), EXIT_SUCCESS);
+    std::ifstream stream{path};
+    const string output{std::istreambuf_iterator<char>{stream}, std::istreambuf_iterator<char>{}};
+    ASSERT_NE(output.find("command.cmd1.duration_ns"), string::npos);
+    for (const auto name: {"cmd2", "batch", "serve", "send"}) {
+        ASSERT_EQ(output.find("command." + string{name}), string::npos);
+    }
+    return;
+}
+
+
+/**
+ * Test the --trace option.
+ */
+TEST_F(CliTest, trace) {
+#if defined(NO_TRACING)
+    GTEST_SKIP() << "spans are compiled out";
+#endif
+    const auto path{tmpdir() + "/trace.json"};
+    cmdl({"{{ cookiecutter.app_name }}", "--trace", path, "cmd1"});
+    ASSERT_EQ(cli(argc, argv), EXIT_SUCCESS);
+    std::ifstream stream{path};
+    const string json{std::istreambuf_iterator<char>{stream}, std::istreambuf_iterator<char>{}};
+    for (const auto name: {"logger.start", "config.load", "logger.restart", "command.dispatch"}) {
+        ASSERT_NE(json.find("\"name\": \"" + string{name} + "\""), string::npos);
+    }
+    return;
+}
+
+
+/**
+ * Test the --profile-startup option.
+ */
+TEST_F(CliTest, profile_startup) {
+    cmdl({"{{ cookiecutter.app_name }}", "--profile-startup", "cmd1"});
+    ASSERT_EQ(cli(argc, argv), EXIT_SUCCESS);
+    const auto profile{stderr.str()};
+    for (const auto name: {"startup profile", "process.init", "cli.parse", "total"}) {
+        ASSERT_NE(profile.find(name), string::npos);
+    }
+    return;
+}
+
+
+/**
+ * Test the --profile option.
+ */
+TEST_F(CliTest, profile) {
+    const auto path{tmpdir() + "/profile.folded"};
+    cmdl({"{{ cookiecutter.app_name }}", "--profile", path, "cmd1"});
+    ASSERT_EQ(cli(argc, argv), EXIT_SUCCESS);
+    ASSERT_TRUE(std::filesystem::is_regular_file(path));
+    return;
+}
+
+
+/**
+ * Test that the command runs if the profiler cannot be started.
+ */
+TEST_F(CliTest, profile_error) {
+    Profiler other;
+    other.start();  // only one profiler can run
+    const auto path{tmpdir() + "/profile.folded"};
+    cmdl({"{{ cookiecutter.app_name }}", "--profile", path, "cmd1"});
+    ASSERT_EQ(cli(argc, argv), EXIT_SUCCESS);
+    ASSERT_NE(stderr.str().find("profiling is disabled"), string::npos);
+    ASSERT_FALSE(std::filesystem::exists(path));
+    return;
+}
+
+
+/**
+ * Test the --perf option.
+ *
+ * The command must succeed whether or not hardware counters are available.
+ */
+TEST_F(CliTest, perf) {
+    cmdl({"{{ cookiecutter.app_name }}", "--perf", "--metrics", "cmd1"});
+    ASSERT_EQ(cli(argc, argv), EXIT_SUCCESS);
+    const auto output{stderr.str()};
+    const auto counted{output.find("command.cmd1.instructions") != string::npos};
+    const auto warned{output.find("hardware counters are not available") != string::npos};
+    ASSERT_TRUE(counted or warned);
+    return;
+}
+
+
+/**
+ * Test the batch subcommand.
+ */
+TEST_F(CliTest, batch) {
+    for (auto jobs: vector<string>{"1", "2"}) {
+        cmdl({"{{ cookiecutter.app_name }}", "batch", "--jobs", jobs, "tests/unit/assets/batch.txt"});
+        ASSERT_EQ(cli(argc, argv), EXIT_FAILURE);  // cmd0 is invalid
+        const string results{"2\t0\tcmd1\n4\t0\t  cmd2\n5\t1\tcmd0\n"};
+        ASSERT_NE(stdout.str().find(results), string::npos);
+        stdout.str("");
+    }
+    return;
+}
+
+
+/**
+ * Test the serve and send subcommands.
+ */
+TEST_F(CliTest, serve) {
+    // The server runs in a separate process because cli() configures the
+    // global logger and config, and these are not shared by concurrent calls.
+    const auto path{tmpdir() + "/serve.sock"};
+    Process server{vector<string>{"serve", "--socket", path}};
+    for (auto tries{0}; tries < 500 and not std::filesystem::exists(path); ++tries) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    cmdl({"{{ cookiecutter.app_name }}", "serve", "--socket", path});
+    ASSERT_EQ(cli(argc, argv), EXIT_FAILURE);  // already running
+    ASSERT_NE(stderr.str().find("already listening"), string::npos);
+    cmdl({"{{ cookiecutter.app_name }}", "send", "--socket", path, "cmd1"});
+    ASSERT_EQ(cli(argc, argv), EXIT_SUCCESS);
+    for (auto subcmd: vector<string>{"batch", "serve"}) {
+        cmdl({"{{ cookiecutter.app_name }}", "send", "--socket", path, subcmd});
+        ASSERT_EQ(cli(argc, argv), EXIT_FAILURE);  // not allowed
+        ASSERT_NE(stdout.str().find("invalid command"), string::npos);
+        stdout.str("");
+    }
+    cmdl({"{{ cookiecutter.app_name }}", "send", "--socket", path, "--stop"});
+    ASSERT_EQ(cli(argc, argv), EXIT_SUCCESS);
+    ASSERT_EQ(server.wait(), EXIT_SUCCESS);
+    ASSERT_FALSE(std::filesystem::exists(path));
+    return;
+}
+
+
+/**
+ * Test that an idle client does not block other clients.
+ */
+TEST_F(CliTest, serve_idle) {
+    const auto config{tmpdir() + "/config.toml"};
+    std::ofstream{config} << "[serve]\ntimeout = 1\n";
+    const auto path{tmpdir() + "/serve.sock"};
+    Process server{vector<string>{"--config", config, "serve", "--socket", path}};
+    for (auto tries{0}; tries < 500 and not std::filesystem::exists(path); ++tries) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    const auto idle{UnixSocket::connect(path)};  // never sends a request
+    const auto client{UnixSocket::connect(path)};
+    client.timeout(std::chrono::seconds(10));  // fail instead of hanging
+    client.send({"cmd1"});
+    UnixSocket::Message message;
+    ASSERT_TRUE(client.recv(message));
+    ASSERT_EQ(message.front(), "0");
+    ASSERT_FALSE(idle.recv(message));  // disconnected by the server
+    client.send({});  // stop
+    ASSERT_TRUE(client.recv(message));
+    ASSERT_EQ(server.wait(), EXIT_SUCCESS);
+    return;
+}
+
+
+/**
+ * Test the send subcommand with an invalid server response.
+ */
+TEST_F(CliTest, send_invalid) {
+    const auto path{tmpdir() + "/serve.sock"};
+    for (const auto status: {"abc", "99999999999"}) {
+        const auto server{UnixSocket::listen(path)};
+        std::thread thread{[&server, status]() {
+            try {
+                const auto client{server.accept()};
+                UnixSocket::Message message;
+                if (client.recv(message)) {
+                    client.send({status, ""});
+                }
+            }
+            catch (const std::system_error&) {}  // checked by the test
+        }};
+        cmdl({"{{ cookiecutter.app_name }}", "send", "--socket", path, "cmd1"});
+        const auto result{cli(argc, argv)};
+        UnixSocket::connect(path);  // don't hang in accept() if cli() did not connect
+        thread.join();
+        ASSERT_EQ(result, EXIT_FAILURE);
+        ASSERT_NE(stderr.str().find("invalid response"), string::npos);
+        stderr.str("");
+    }
+    return;
+}
@@ -5,8 +5,14 @@
  * test runner.
  */
 #include "core/configure.hpp"
+#include "core/memory.hpp"
+#include "core/numeric.hpp"
 #include <gtest/gtest.h>
 #include <fstream>
+#include <memory_resource>
+#include <sstream>
+#include <stdexcept>
+#include <tuple>
 #include <vector>
 
 using namespace configure;
@@ -17,6 +23,31 @@ using std::vector;
 using testing::Test;
 
 
+/**
+ * Settings struct for testing config binding.
+ */
+struct Settings {
+    std::string key;
+    int integer;
+    double real;
+    bool boolean;
+};
+
+
+/**
+ * Config fields for Settings.
+ */
+template <>
+struct configure::Schema<Settings> {
+    static constexpr auto fields{std::make_tuple(
+        field("section1.key1", &Settings::key),
+        field("types.int", &Settings::integer),
+        field("types.float", &Settings::real),
+        field("types.bool", &Settings::boolean)
+    )};
+};
+
+
 /**
  * Test fixture for the configure test suite.
  *
@@ -105,6 +136,32 @@ TEST_F(ConfigTest, load_toml) {
 }
 
 
+/**
+ * Test the load_text() method.
+ */
+TEST_F(ConfigTest, load_text) {
+    Config config;
+    config.load_text("key1 = \"value1\"\n[section1]\nkey2 = \"value2\"\n");
+    ASSERT_EQ(config["key1"], "value1");
+    ASSERT_EQ(config["section1.key2"], "value2");
+}
+
+
+/**
+ * Test the stored text of scalar values.
+ */
+TEST_F(ConfigTest, load_types) {
+    Config config;
+    config.load_text("int = -12\nfloat = 0.1\nbool = false\n");
+    ASSERT_EQ(config["int"], "-12");
+    double real;
+    ASSERT_TRUE(numeric::parse(config["float"], real));
+    ASSERT_EQ(real, 0.1);  // no loss of precision
+    ASSERT_EQ(config["bool"], "false");
+    ASSERT_THROW(config.load_text("array = [1, 2]\n"), std::invalid_argument);
+}
+
+
 /**
  * Test value access.
  */
@@ -116,3 +173,72 @@ TEST_F(ConfigTest, access) {
         ASSERT_EQ(config[keys[pos]], values[pos]);
     }
 }
+
+
+/**
+ * Test the get() method.
+ */
+TEST_F(ConfigTest, get) {
+    Config config{path};
+    const auto settings{config.get<Settings>()};
+    ASSERT_EQ(settings.key, "value1");
+    ASSERT_EQ(settings.integer, 123);
+    ASSERT_EQ(settings.real, 1.5);
+    ASSERT_TRUE(settings.boolean);
+    config["types.int"] = "abc";
+    ASSERT_THROW(config.get<Settings>(), std::invalid_argument);
+    ASSERT_THROW(Config{}.get<Settings>(), std::out_of_range);
+}
+
+
+/**
+ * Test the get() method with a memory resource.
+ */
+TEST_F(ConfigTest, get_resource) {
+    const Config config{path};
+    std::pmr::monotonic_buffer_resource arena;
+    const auto value{config.get("key1", &arena)};
+    ASSERT_EQ(value, "value1");
+    ASSERT_EQ(value.get_allocator().resource(), &arena);
+    ASSERT_THROW(config.get("none", &arena), std::out_of_range);
+}
+
+
+/**
+ * Test the allocation budget for value lookups.
+ *
+ * Lookups of existing keys, and get() with a memory resource that has enough
+ * space, must not allocate from the heap.
+ */
+TEST_F(ConfigTest, budget) {
+    const Config config{path};
+    char buffer[256];
+    std::pmr::monotonic_buffer_resource arena{buffer, sizeof(buffer), std::pmr::null_memory_resource()};
+    const memory::Usage usage;
+    ASSERT_EQ(config["key1"], "value1");
+    ASSERT_EQ(config.get("key1", &arena), "value1");
+    ASSERT_EQ(usage.get().allocations, 0);
+}
+
+
+/**
+ * Test the bind() method.
+ */
+TEST_F(ConfigTest, bind) {
+    Config config{path};
+    Settings settings;
+    config.bind(settings);
+    ASSERT_EQ(settings.integer, 123);
+    std::istringstream stream{"[types]\nint = 456\n"};
+    config.load(stream);  // bound struct is updated
+    ASSERT_EQ(settings.integer, 456);
+    ASSERT_EQ(settings.key, "value1");
+}
+
+
+/**
+ * Test the config() accessor.
+ */
+TEST(ConfigureTest, config) {
+    ASSERT_EQ(&configure::config(), &configure::config());
+}
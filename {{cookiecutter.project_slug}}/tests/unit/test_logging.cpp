@@ -5,9 +5,11 @@
  * test runner.
  */
 #include "core/logging.hpp"
+#include "core/memory.hpp"
 #include <gtest/gtest.h>
 #include <list>
 #include <sstream>
+#include <thread>
 
 #include <iostream>
 
@@ -164,3 +166,31 @@ TEST_P(LoggerTest, fatal) {
     }
     return;
 }
+
+
+/**
+ * Test the allocation budget for a message below the logger level.
+ *
+ * Filtered messages are common in hot code, so they must not allocate.
+ */
+TEST_P(LoggerTest, budget) {
+    const memory::Usage usage;
+    logger.debug(message);
+    ASSERT_EQ(usage.get().allocations, 0);
+    return;
+}
+
+
+/**
+ * Test the logger() accessor.
+ */
+TEST(LoggingTest, logger) {
+    // Every thread must get the same instance.
+    Logger* other{nullptr};
+    std::thread thread{[&other]() { other = &logger(); }};
+    thread.join();
+    ASSERT_EQ(&logger(), other);
+    const memory::Usage usage;
+    logger();  // already constructed
+    ASSERT_EQ(usage.get().allocations, 0);
+}
@@ -0,0 +1,55 @@
+/**
+ * Test suite for the memory module.
+ *
+ * Link all test files with the `gtest_main` library to create a command-line
+ * test runner.
+ */
+#include "core/memory.hpp"
+#include <gtest/gtest.h>
+#include <memory>
+#include <new>
+#include <thread>
+#include <vector>
+
+
+/**
+ * Test the Usage class.
+ */
+TEST(MemoryTest, usage) {
+    ASSERT_TRUE(memory::tracking());
+    const memory::Usage usage;
+    {
+        const auto value{std::make_unique<int>(1)};
+        const std::vector<char> buffer(1000);
+        const auto aligned{new (std::align_val_t{64}) char[64]};
+        ASSERT_EQ(usage.get().allocations, 3);
+        ASSERT_GE(usage.get().live, 1000 + 64 + sizeof(int));
+        operator delete[](aligned, std::align_val_t{64});
+    }
+    const auto stats{usage.get()};
+    ASSERT_EQ(stats.deallocations, 3);
+    ASSERT_GE(stats.bytes, 1000 + 64 + sizeof(int));
+    ASSERT_EQ(stats.live, 0);
+}
+
+
+/**
+ * Test that counts are per thread.
+ */
+TEST(MemoryTest, thread) {
+    const memory::Usage usage;
+    std::thread{[]() { const std::vector<char> buffer(1000); }}.join();
+    ASSERT_LE(usage.get().bytes, 1000);  // the thread object may allocate
+}
+
+
+/**
+ * Test the RSS functions.
+ */
+TEST(MemoryTest, rss) {
+    ASSERT_GT(memory::peak_rss(), 0);
+#if defined(__linux__)
+    ASSERT_GT(memory::rss(), 0);
+    ASSERT_LE(memory::rss(), memory::peak_rss());
+#endif
+}
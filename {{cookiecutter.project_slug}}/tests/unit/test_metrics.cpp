@@ -0,0 +1,171 @@
+/**
+ * Test suite for the metrics module.
+ *
+ * Link all test files with the `gtest_main` library to create a command-line
+ * test runner.
+ */
+#include "core/metrics.hpp"
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace metrics;
+using std::string;
+
+
+/**
+ * Test the Counter class.
+ */
+TEST(CounterTest, add) {
+    Counter counter;
+    std::vector<std::thread> threads;
+    for (int thread{0}; thread < 4; ++thread) {
+        threads.emplace_back([&counter]() {
+            for (int count{0}; count < 1000; ++count) {
+                counter.add();
+            }
+        });
+    }
+    for (auto& thread: threads) {
+        thread.join();
+    }
+    counter.add(10);
+    ASSERT_EQ(counter.value(), 4010);
+}
+
+
+/**
+ * Test the Gauge class.
+ */
+TEST(GaugeTest, set) {
+    Gauge gauge;
+    gauge.set(5);
+    gauge.add(-2);
+    ASSERT_EQ(gauge.value(), 3);
+}
+
+
+/**
+ * Test histogram buckets.
+ */
+TEST(HistogramTest, bucket) {
+    for (const std::uint64_t value: {0ul, 15ul, 16ul, 17ul, 1000ul, 123456789ul, ~0ul}) {
+        const auto index{Histogram::bucket(value)};
+        ASSERT_LT(index, Histogram::buckets);
+        ASSERT_GE(Histogram::upper(index), value);
+        ASSERT_LE(Histogram::upper(index) - value, value / 16);  // precision
+        if (index > 0) {
+            ASSERT_LT(Histogram::upper(index - 1), value);
+        }
+    }
+}
+
+
+/**
+ * Test the Histogram class.
+ */
+TEST(HistogramTest, snapshot) {
+    Histogram histogram;
+    ASSERT_EQ(histogram.snapshot().percentile(50), 0);
+    for (std::uint64_t value{1}; value <= 1000; ++value) {
+        histogram.record(value);
+    }
+    const auto data{histogram.snapshot()};
+    ASSERT_EQ(data.count, 1000);
+    ASSERT_EQ(data.sum, 500500);
+    ASSERT_NEAR(data.percentile(50), 500, 500 / 16);
+    ASSERT_NEAR(data.percentile(99), 990, 990 / 16);
+    ASSERT_NEAR(data.max(), 1000, 1000 / 16);
+}
+
+
+/**
+ * Test the Registry class.
+ */
+TEST(RegistryTest, output) {
+    Registry registry;
+    ASSERT_EQ(&registry.counter("test.calls"), &registry.counter("test.calls"));
+    registry.counter("test.calls").add(2);
+    registry.gauge("test.size").set(3);
+    registry.histogram("test.duration").record(100);
+    std::ostringstream dump;
+    registry.dump(dump);
+    ASSERT_NE(dump.str().find("test.calls 2\n"), string::npos);
+    ASSERT_NE(dump.str().find("test.size 3\n"), string::npos);
+    ASSERT_NE(dump.str().find("test.duration count=1 mean=100"), string::npos);
+    std::ostringstream text;
+    registry.prometheus(text);
+    ASSERT_NE(text.str().find("# TYPE test_calls_total counter\ntest_calls_total 2\n"), string::npos);
+    ASSERT_NE(text.str().find("test_duration_bucket{le=\"0\"} 0\n"), string::npos);  // empty
+    ASSERT_NE(text.str().find("test_duration_bucket{le=\"63\"} 0\n"), string::npos);
+    ASSERT_NE(text.str().find("test_duration_bucket{le=\"127\"} 1\n"), string::npos);
+    ASSERT_NE(text.str().find("test_duration_bucket{le=\"+Inf\"} 1\n"), string::npos);
+    ASSERT_NE(text.str().find("test_duration_sum 100\n"), string::npos);
+}
+
+
+/**
+ * Test that Prometheus histogram buckets do not depend on the data.
+ */
+TEST(RegistryTest, buckets) {
+    const auto buckets([](const Registry& registry) {
+        std::ostringstream text;
+        registry.prometheus(text);
+        const auto str{text.str()};
+        size_t count{0};
+        for (auto pos{str.find("_bucket{")}; pos != string::npos; pos = str.find("_bucket{", pos + 1)) {
+            ++count;
+        }
+        return count;
+    });
+    Registry registry;
+    registry.histogram("empty");
+    const auto count{buckets(registry)};
+    ASSERT_EQ(count, 65);  // 2^k - 1 for k in [0, 64), and +Inf
+    registry.histogram("empty").record(1);
+    registry.histogram("empty").record(1000000);
+    ASSERT_EQ(buckets(registry), count);
+}
+
+
+/**
+ * Test the registry() accessor.
+ */
+TEST(RegistryTest, global) {
+    // Every thread must get the same instance.
+    Registry* other{nullptr};
+    std::thread thread{[&other]() { other = &registry(); }};
+    thread.join();
+    ASSERT_EQ(&registry(), other);
+}
+
+
+/**
+ * Test the Exporter class.
+ */
+TEST(ExporterTest, write) {
+    char temp[]{"/tmp/ExporterTest.XXXXXX"};
+    const auto fd{mkstemp(temp)};
+    ASSERT_NE(fd, -1);
+    close(fd);
+    const string path{temp};
+    Registry registry;
+    registry.counter("test").add();
+    {
+        const Exporter exporter{registry, path, std::chrono::milliseconds(1)};
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        registry.counter("test").add();
+    }
+    std::ifstream stream{path};
+    const string text{std::istreambuf_iterator<char>{stream}, std::istreambuf_iterator<char>{}};
+    ASSERT_NE(text.find("test_total 2\n"), string::npos);  // final write
+    std::remove(path.c_str());
+}
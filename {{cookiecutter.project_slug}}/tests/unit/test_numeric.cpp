@@ -0,0 +1,43 @@
+/**
+ * Test suite for the numeric module.
+ *
+ * Link all test files with the `gtest_main` library to create a command-line
+ * test runner.
+ */
+#include "core/numeric.hpp"
+#include <gtest/gtest.h>
+#include <cstdint>
+
+
+/**
+ * Test integer parsing.
+ */
+TEST(NumericTest, integer) {
+    int value{0};
+    ASSERT_TRUE(numeric::parse("-123", value));
+    ASSERT_EQ(value, -123);
+    for (const auto str: {"", "1.5", "12abc", " 1", "+1", "0x10"}) {
+        ASSERT_FALSE(numeric::parse(str, value)) << str;
+    }
+    std::uint8_t small{0};
+    ASSERT_FALSE(numeric::parse("256", small));  // out of range
+    ASSERT_FALSE(numeric::parse("-1", small));
+}
+
+
+/**
+ * Test floating point parsing.
+ */
+TEST(NumericTest, real) {
+    double value{0};
+    ASSERT_TRUE(numeric::parse("1.5", value));
+    ASSERT_EQ(value, 1.5);
+    ASSERT_TRUE(numeric::parse("-2e3", value));
+    ASSERT_EQ(value, -2000);
+    float single{0};
+    ASSERT_TRUE(numeric::parse("0.25", single));
+    ASSERT_EQ(single, 0.25f);
+    for (const auto str: {"", "1.5x", " 1.5", "+1.5", "1e999"}) {
+        ASSERT_FALSE(numeric::parse(str, value)) << str;
+    }
+}
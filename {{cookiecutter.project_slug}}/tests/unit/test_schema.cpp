@@ -0,0 +1,179 @@
+/**
+ * Test suite for the schema module.
+ *
+ * Link all test files with the `gtest_main` library to create a command-line
+ * test runner.
+ */
+#include "core/schema.hpp"
+#include <gtest/gtest.h>
+#include <cassert>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using schema::command;
+using schema::opt;
+using schema::pos;
+using schema::sub;
+using std::string;
+using std::string_view;
+using std::vector;
+using testing::Test;
+
+
+namespace {
+    /**
+     * Subcommand results.
+     */
+    struct SubArgs {
+        bool force;
+        string_view name;
+    };
+
+    /**
+     * Command results.
+     */
+    struct Args {
+        bool verbose;
+        int jobs{1};
+        vector<double> scale;
+        vector<string_view> files;
+        std::optional<SubArgs> run;
+    };
+
+    constexpr auto sub_schema{command<SubArgs>(
+        opt("force", 'f', &SubArgs::force),
+        pos("name", &SubArgs::name)
+    )};
+
+    constexpr auto args_schema{command<Args>(
+        opt("verbose", 'v', &Args::verbose),
+        opt("jobs", 'j', &Args::jobs),
+        opt("scale", &Args::scale),
+        sub("run", &Args::run, sub_schema),
+        pos("files", &Args::files)
+    )};
+}
+
+
+/**
+ * Test fixture for the schema test suite.
+ *
+ * This is used to group tests and provide common set-up and tear-down code.
+ * A new test fixture is created for each test to prevent any side effects
+ * between tests. Member variables and methods are injected into each test that
+ * uses this fixture.
+ */
+class SchemaTest: public Test {
+protected:
+    /**
+     * Tear down the test fixture.
+     */
+    ~SchemaTest() {
+        dealloc();
+    }
+
+    /**
+     * Set command-line arguments.
+     */
+    void args(const vector<string>& args) {
+        dealloc();
+        argc = static_cast<int>(args.size());
+        argv = new char*[argc];
+        auto iter(args.begin());
+        for (int pos{0}; pos < argc; ++pos, ++iter) {
+            const size_t len{iter->size() + 1};
+            argv[pos] = new char[len];
+            assert(std::strncpy(argv[pos], iter->c_str(), len) != nullptr);
+        }
+        return;
+    }
+
+    int argc{0};
+    char** argv{nullptr};
+
+private:
+    /**
+     * Deallocate argv.
+     */
+    void dealloc() {
+        for (int pos{0}; pos < argc; ++pos) {
+            delete[] argv[pos];
+        }
+        delete[] argv;
+        argv = nullptr;
+        argc = 0;
+        return;
+    }
+};
+
+
+/**
+ * Test the parse() method for options and positional arguments.
+ */
+TEST_F(SchemaTest, parse) {
+    args({"cmd", "-v", "-j4", "--scale=0.5", "--scale", "2", "--", "-abc", "def"});
+    const auto result{args_schema.parse(argc, argv)};
+    ASSERT_TRUE(result.verbose);
+    ASSERT_EQ(4, result.jobs);
+    ASSERT_EQ((vector<double>{0.5, 2}), result.scale);
+    ASSERT_EQ((vector<string_view>{"-abc", "def"}), result.files);
+    ASSERT_FALSE(result.run);
+    return;
+}
+
+
+/**
+ * Test the parse() method for a subcommand.
+ */
+TEST_F(SchemaTest, parse_sub) {
+    args({"cmd", "--jobs", "2", "run", "-f", "abc"});
+    const auto result{args_schema.parse(argc, argv)};
+    ASSERT_EQ(2, result.jobs);
+    ASSERT_FALSE(result.verbose);
+    ASSERT_TRUE(result.run);
+    ASSERT_TRUE(result.run->force);
+    ASSERT_EQ("abc", result.run->name);
+    return;
+}
+
+
+/**
+ * Test the parse() method with error handling.
+ */
+TEST_F(SchemaTest, parse_err) {
+    for (const auto& arg: vector<string>{"--none", "-x", "--jobs=abc", "--verbose=1", "--jobs"}) {
+        args({"cmd", arg});
+        ASSERT_THROW(args_schema.parse(argc, argv), std::runtime_error);
+    }
+    args({"cmd", "run"});  // missing argument
+    ASSERT_THROW(args_schema.parse(argc, argv), std::runtime_error);
+    args({"cmd", "run", "abc", "def"});  // unexpected argument
+    ASSERT_THROW(args_schema.parse(argc, argv), std::runtime_error);
+    return;
+}
+
+
+/**
+ * Test the usage() method.
+ */
+TEST_F(SchemaTest, usage) {
+    const string usage{"usage: cmd [-v|--verbose] [-j|--jobs VALUE] [--scale VALUE] files... [run] ..."};
+    ASSERT_EQ(usage, args_schema.usage("cmd"));
+    return;
+}
+
+
+/**
+ * Test schema validation.
+ */
+TEST_F(SchemaTest, check) {
+    // A constexpr schema with a duplicate would not compile; a runtime schema
+    // throws an exception.
+    ASSERT_THROW(command<Args>(opt("verbose", 'v', &Args::verbose), opt("jobs", 'v', &Args::jobs)), std::logic_error);
+    ASSERT_THROW(command<Args>(opt("jobs", &Args::verbose), opt("jobs", &Args::jobs)), std::logic_error);
+    return;
+}
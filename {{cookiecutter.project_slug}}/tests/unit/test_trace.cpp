@@ -0,0 +1,57 @@
+/**
+ * Test suite for the trace module.
+ *
+ * Link all test files with the `gtest_main` library to create a command-line
+ * test runner.
+ */
+#include "core/trace.hpp"
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using std::string;
+
+
+/**
+ * Test that spans are only recorded while tracing is enabled.
+ */
+TEST(TraceTest, enabled) {
+    {
+        const trace::Span span{"TraceTest.disabled"};
+    }
+    trace::start();
+    ASSERT_TRUE(trace::enabled());
+    {
+        const trace::Span span{"TraceTest.enabled"};
+    }
+    std::thread{[]() { const trace::Span span{"TraceTest.thread"}; }}.join();
+    trace::stop();
+    {
+        const trace::Span span{"TraceTest.stopped"};
+    }
+    std::ostringstream stream;
+    trace::write(stream);
+    const auto json{stream.str()};
+    ASSERT_EQ(json.find("TraceTest.disabled"), string::npos);
+    ASSERT_EQ(json.find("TraceTest.stopped"), string::npos);
+    ASSERT_NE(json.find(R"("name": "TraceTest.enabled", "ph": "X")"), string::npos);
+    ASSERT_NE(json.find(R"("name": "TraceTest.thread")"), string::npos);
+    ASSERT_EQ(json.rfind(R"({"traceEvents": [)", 0), 0);
+}
+
+
+/**
+ * Test that start() discards previous spans.
+ */
+TEST(TraceTest, start) {
+    trace::start();
+    {
+        const trace::Span span{"TraceTest.first"};
+    }
+    trace::start();
+    trace::stop();
+    std::ostringstream stream;
+    trace::write(stream);
+    ASSERT_EQ(stream.str().find("TraceTest.first"), string::npos);
+}